@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "cs402.h"
+#include "my402clist.h"
+
+#define ANCHOR 0
+#define GROW_STEP_LIMIT (1 << 20)
+
+int My402CListLength(My402CList *list) {
+    return list->num_members;
+}
+
+int My402CListEmpty(My402CList *list) {
+    return list->num_members <= 0;
+}
+
+static int Resize(My402CList *list, size_t num_slots) {
+    if (num_slots > UINT32_MAX) {
+        return FALSE;
+    }
+    My402CListNode *nodes = realloc(list->nodes, num_slots * sizeof(My402CListNode));
+    if (nodes == NULL) {
+        return FALSE;
+    }
+    list->nodes = nodes;
+    list->num_slots = num_slots;
+    return TRUE;
+}
+
+// Small arrays double; past GROW_STEP_LIMIT slots the array grows by a quarter, so
+// unused capacity stays under 25% for very long lists.
+static int Grow(My402CList *list) {
+    size_t num_slots = list->num_slots;
+    if (num_slots >= UINT32_MAX) {
+        return FALSE;
+    }
+    num_slots += num_slots < GROW_STEP_LIMIT ? num_slots : num_slots / 4;
+    return Resize(list, min(num_slots, UINT32_MAX));
+}
+
+// Take a node off the free stack, or from the end of the array (doubling it if full).
+static My402CListIndex NewNode(My402CList *list, void *obj) {
+    My402CListIndex index = list->free_top;
+    if (index != ANCHOR) {
+        list->free_top = list->nodes[index].next;
+    } else {
+        if (list->num_nodes == list->num_slots && !Grow(list)) {
+            return ANCHOR;
+        }
+        index = list->num_nodes++;
+    }
+    list->nodes[index].obj = obj;
+    return index;
+}
+
+// Link node index in between prev and next.
+static void Link(My402CList *list, My402CListIndex index, My402CListIndex prev, My402CListIndex next) {
+    My402CListNode *nodes = list->nodes;
+    nodes[index].prev = prev;
+    nodes[index].next = next;
+    nodes[prev].next = index;
+    nodes[next].prev = index;
+    list->num_members++;
+}
+
+int My402CListAppend(My402CList *list, void *obj) {
+    My402CListIndex index = NewNode(list, obj);
+    if (index == ANCHOR) {
+        return FALSE;
+    }
+    Link(list, index, list->nodes[ANCHOR].prev, ANCHOR);
+    return TRUE;
+}
+
+int My402CListPrepend(My402CList *list, void *obj) {
+    My402CListIndex index = NewNode(list, obj);
+    if (index == ANCHOR) {
+        return FALSE;
+    }
+    Link(list, index, ANCHOR, list->nodes[ANCHOR].next);
+    return TRUE;
+}
+
+void My402CListUnlink(My402CList *list, My402CListIndex index) {
+    if (My402CListEmpty(list) || index == ANCHOR) {
+        return;
+    }
+    My402CListNode *nodes = list->nodes;
+    nodes[nodes[index].prev].next = nodes[index].next;
+    nodes[nodes[index].next].prev = nodes[index].prev;
+    nodes[index].obj = NULL;
+    nodes[index].next = list->free_top;
+    list->free_top = index;
+    list->num_members--;
+}
+
+// Keeps the array so the list can be refilled without reallocating.
+void My402CListUnlinkAll(My402CList *list) {
+    list->num_members = 0;
+    list->num_nodes = 1;
+    list->free_top = ANCHOR;
+    list->nodes[ANCHOR].next = ANCHOR;
+    list->nodes[ANCHOR].prev = ANCHOR;
+}
+
+int My402CListInsertAfter(My402CList *list, void *obj, My402CListIndex elem) {
+    if (elem == ANCHOR) {
+        return My402CListAppend(list, obj);
+    }
+    My402CListIndex index = NewNode(list, obj);
+    if (index == ANCHOR) {
+        return FALSE;
+    }
+    Link(list, index, elem, list->nodes[elem].next);
+    return TRUE;
+}
+
+int My402CListInsertBefore(My402CList *list, void *obj, My402CListIndex elem) {
+    if (elem == ANCHOR) {
+        return My402CListPrepend(list, obj);
+    }
+    My402CListIndex index = NewNode(list, obj);
+    if (index == ANCHOR) {
+        return FALSE;
+    }
+    Link(list, index, list->nodes[elem].prev, elem);
+    return TRUE;
+}
+
+My402CListIndex My402CListFirst(My402CList *list) {
+    return list->nodes[ANCHOR].next;
+}
+
+My402CListIndex My402CListLast(My402CList *list) {
+    return list->nodes[ANCHOR].prev;
+}
+
+My402CListIndex My402CListNext(My402CList *list, My402CListIndex index) {
+    return list->nodes[index].next;
+}
+
+My402CListIndex My402CListPrev(My402CList *list, My402CListIndex index) {
+    return list->nodes[index].prev;
+}
+
+My402CListIndex My402CListFind(My402CList *list, void *obj) {
+    for (My402CListIndex index = My402CListFirst(list); index != ANCHOR; index = My402CListNext(list, index)) {
+        if (list->nodes[index].obj == obj) {
+            return index;
+        }
+    }
+    return ANCHOR;
+}
+
+void *My402CListObj(My402CList *list, My402CListIndex index) {
+    return index == ANCHOR ? NULL : list->nodes[index].obj;
+}
+
+int My402CListReserve(My402CList *list, int num_members) {
+    if ((size_t) num_members + 1 <= list->num_slots) {
+        return TRUE;
+    }
+    return Resize(list, (size_t) num_members + 1);
+}
+
+size_t My402CListMemory(My402CList *list) {
+    return sizeof(My402CList) + (size_t) list->num_slots * sizeof(My402CListNode);
+}
+
+int My402CListInit(My402CList *list) {
+    list->num_slots = 16;
+    list->nodes = malloc(list->num_slots * sizeof(My402CListNode));
+    if (list->nodes == NULL) {
+        return FALSE;
+    }
+    list->nodes[ANCHOR].obj = NULL;
+    My402CListUnlinkAll(list);
+    return TRUE;
+}
+
+void My402CListFree(My402CList *list) {
+    free(list->nodes);
+    list->nodes = NULL;
+    list->num_slots = 0;
+    list->num_nodes = 0;
+    list->num_members = 0;
+    list->free_top = ANCHOR;
+}
@@ -0,0 +1,62 @@
+#ifndef _MY402CLIST_H_
+#define _MY402CLIST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cs402.h"
+
+/*
+ * Compact companion to My402List for very long lists.  All nodes live in one
+ * growable array and link to each other by 32-bit index, so a node is 16
+ * bytes (obj plus next and prev) with no per-node malloc header, against
+ * 24 bytes plus the malloc header for a My402ListElem.  Unlinked nodes are
+ * pushed on a free-index stack threaded through their next field and reused
+ * first.
+ *
+ * Elements are named by index.  Slot 0 is the anchor, so 0 plays the role
+ * NULL plays for My402List.  Indices stay valid while the array grows.
+ */
+typedef uint32_t My402CListIndex;
+
+typedef struct tagMy402CListNode {
+    void *obj;
+    My402CListIndex next;
+    My402CListIndex prev;
+} My402CListNode;
+
+typedef struct tagMy402CList {
+    int num_members;
+    My402CListIndex num_nodes;      /* slots in use or on the free stack, anchor included */
+    My402CListIndex num_slots;      /* allocated slots */
+    My402CListIndex free_top;       /* top of the free-index stack, 0 if empty */
+    My402CListNode *nodes;
+} My402CList;
+
+extern int  My402CListLength(My402CList*);
+extern int  My402CListEmpty(My402CList*);
+
+extern int  My402CListAppend(My402CList*, void*);
+extern int  My402CListPrepend(My402CList*, void*);
+extern void My402CListUnlink(My402CList*, My402CListIndex);
+extern void My402CListUnlinkAll(My402CList*);
+extern int  My402CListInsertAfter(My402CList*, void*, My402CListIndex);
+extern int  My402CListInsertBefore(My402CList*, void*, My402CListIndex);
+
+extern My402CListIndex My402CListFirst(My402CList*);
+extern My402CListIndex My402CListLast(My402CList*);
+extern My402CListIndex My402CListNext(My402CList*, My402CListIndex);
+extern My402CListIndex My402CListPrev(My402CList*, My402CListIndex);
+
+extern My402CListIndex My402CListFind(My402CList*, void*);
+extern void *My402CListObj(My402CList*, My402CListIndex);
+
+/* Size the array for num_members elements up front, avoiding spare capacity. */
+extern int  My402CListReserve(My402CList*, int num_members);
+
+/* Bytes held by the list, including unused capacity. */
+extern size_t My402CListMemory(My402CList*);
+
+extern int  My402CListInit(My402CList*);
+extern void My402CListFree(My402CList*);
+
+#endif /*_MY402CLIST_H_*/
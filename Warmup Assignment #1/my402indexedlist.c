@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "cs402.h"
+#include "my402list.h"
+#include "my402indexedlist.h"
+
+static unsigned long HashObj(void *obj, int num_slots) {
+    unsigned long h = (unsigned long) obj;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdUL;
+    h ^= h >> 33;
+    return h & (num_slots - 1);
+}
+
+static void IndexPut(My402IndexedList *il, My402ListElem *elem) {
+    unsigned long i = HashObj(elem->obj, il->num_slots);
+    while (il->slots[i].elem != NULL) {
+        i = (i + 1) & (il->num_slots - 1);
+    }
+    il->slots[i].obj = elem->obj;
+    il->slots[i].elem = elem;
+    il->num_used++;
+}
+
+// Make room for count more elements, keeping the table at most half full.
+static int IndexReserve(My402IndexedList *il, int count) {
+    if (2 * (il->num_used + count) <= il->num_slots) {
+        return TRUE;
+    }
+    int num_slots = il->num_slots;
+    while (2 * (il->num_used + count) > num_slots) {
+        num_slots *= 2;
+    }
+    My402ListIndexSlot *slots = calloc(num_slots, sizeof(My402ListIndexSlot));
+    if (slots == NULL) {
+        return FALSE;
+    }
+    My402ListIndexSlot *old_slots = il->slots;
+    int old_num_slots = il->num_slots;
+    il->slots = slots;
+    il->num_slots = num_slots;
+    il->num_used = 0;
+    for (int i = 0; i < old_num_slots; i++) {
+        if (old_slots[i].elem != NULL) {
+            IndexPut(il, old_slots[i].elem);
+        }
+    }
+    free(old_slots);
+    return TRUE;
+}
+
+static void IndexRemove(My402IndexedList *il, My402ListElem *elem) {
+    int mask = il->num_slots - 1;
+    unsigned long i = HashObj(elem->obj, il->num_slots);
+    while (il->slots[i].elem != elem) {
+        if (il->slots[i].elem == NULL) {
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    // Backward-shift deletion: pull later entries of the probe run into the hole.
+    unsigned long hole = i;
+    for (unsigned long j = (i + 1) & mask; il->slots[j].elem != NULL; j = (j + 1) & mask) {
+        unsigned long home = HashObj(il->slots[j].obj, il->num_slots);
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            il->slots[hole] = il->slots[j];
+            hole = j;
+        }
+    }
+    il->slots[hole].obj = NULL;
+    il->slots[hole].elem = NULL;
+    il->num_used--;
+}
+
+// Link obj in after prev (which may be the anchor) with the plain list call, then
+// index the new element. Room is reserved first so that indexing cannot fail.
+static int LinkAfter(My402IndexedList *il, void *obj, My402ListElem *prev) {
+    if (!IndexReserve(il, 1)) {
+        return FALSE;
+    }
+    My402List *list = &(il->list);
+    int ok;
+    if (prev == &(list->anchor)) {
+        ok = My402ListPrepend(list, obj);
+    } else if (prev == (list->anchor).prev) {
+        ok = My402ListAppend(list, obj);
+    } else {
+        ok = My402ListInsertAfter(list, obj, prev);
+    }
+    if (!ok) {
+        return FALSE;
+    }
+    IndexPut(il, prev->next);
+    return TRUE;
+}
+
+int My402IndexedListAppend(My402IndexedList *il, void *obj) {
+    return LinkAfter(il, obj, (il->list.anchor).prev);
+}
+
+int My402IndexedListPrepend(My402IndexedList *il, void *obj) {
+    return LinkAfter(il, obj, &(il->list.anchor));
+}
+
+int My402IndexedListInsertAfter(My402IndexedList *il, void *obj, My402ListElem *elem) {
+    return LinkAfter(il, obj, elem == NULL ? (il->list.anchor).prev : elem);
+}
+
+int My402IndexedListInsertBefore(My402IndexedList *il, void *obj, My402ListElem *elem) {
+    return LinkAfter(il, obj, elem == NULL ? &(il->list.anchor) : elem->prev);
+}
+
+void My402IndexedListUnlink(My402IndexedList *il, My402ListElem *elem) {
+    if (il->list.num_members <= 0) {
+        return;
+    }
+    IndexRemove(il, elem);
+    My402ListUnlink(&(il->list), elem);
+}
+
+// The index is cleared in bulk rather than entry by entry.
+void My402IndexedListUnlinkAll(My402IndexedList *il) {
+    My402ListUnlinkAll(&(il->list));
+    memset(il->slots, 0, il->num_slots * sizeof(My402ListIndexSlot));
+    il->num_used = 0;
+}
+
+My402ListElem *My402IndexedListFind(My402IndexedList *il, void *obj) {
+    unsigned long i = HashObj(obj, il->num_slots);
+    while (il->slots[i].elem != NULL) {
+        if (il->slots[i].obj == obj) {
+            return il->slots[i].elem;
+        }
+        i = (i + 1) & (il->num_slots - 1);
+    }
+    return NULL;
+}
+
+int My402IndexedListInit(My402IndexedList *il) {
+    if (!My402ListInit(&(il->list))) {
+        return FALSE;
+    }
+    il->num_slots = 16;
+    il->num_used = 0;
+    il->slots = calloc(il->num_slots, sizeof(My402ListIndexSlot));
+    return il->slots != NULL;
+}
+
+void My402IndexedListDestroy(My402IndexedList *il, void (*destructor)(void*)) {
+    My402ListDestroy(&(il->list), destructor);
+    free(il->slots);
+    il->slots = NULL;
+    il->num_slots = 0;
+    il->num_used = 0;
+}
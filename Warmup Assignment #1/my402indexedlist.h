@@ -0,0 +1,49 @@
+#ifndef _MY402INDEXEDLIST_H_
+#define _MY402INDEXEDLIST_H_
+
+#include "cs402.h"
+#include "my402list.h"
+
+/*
+ * A My402List with a side index from obj to its My402ListElem, so that Find
+ * is expected O(1) instead of a scan.  The index is an open-addressing
+ * (linear probing) hash table of 16-byte slots kept at most half full, so it
+ * costs between 32 and 64 bytes per element on top of the list itself.  If
+ * the same obj is on the list more than once, Find returns one of its
+ * elements, not necessarily the first.
+ *
+ * The "list" member can be read with the usual My402ListFirst/Next/...
+ * calls and sorted with My402ListSort(), but elements must only be added or
+ * removed through the My402IndexedList functions, which keep the index in
+ * step.  Plain lists pay nothing for this.
+ */
+typedef struct tagMy402ListIndexSlot {
+    void *obj;
+    My402ListElem *elem;            /* NULL means the slot is free */
+} My402ListIndexSlot;
+
+typedef struct tagMy402IndexedList {
+    My402List list;
+    int num_slots;                  /* always a power of two */
+    int num_used;
+    My402ListIndexSlot *slots;
+} My402IndexedList;
+
+extern int  My402IndexedListInit(My402IndexedList*);
+
+extern int  My402IndexedListAppend(My402IndexedList*, void*);
+extern int  My402IndexedListPrepend(My402IndexedList*, void*);
+extern void My402IndexedListUnlink(My402IndexedList*, My402ListElem*);
+extern void My402IndexedListUnlinkAll(My402IndexedList*);
+extern int  My402IndexedListInsertAfter(My402IndexedList*, void*, My402ListElem*);
+extern int  My402IndexedListInsertBefore(My402IndexedList*, void*, My402ListElem*);
+
+extern My402ListElem *My402IndexedListFind(My402IndexedList*, void*);
+
+/*
+ * Unlink every element, call destructor (if not NULL) on each obj, and free
+ * the index.  My402IndexedListInit() must be called again before reuse.
+ */
+extern void My402IndexedListDestroy(My402IndexedList*, void (*destructor)(void*));
+
+#endif /*_MY402INDEXEDLIST_H_*/
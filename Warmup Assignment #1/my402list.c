@@ -2,63 +2,147 @@
 #include <string.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#ifdef MY402LIST_STATS
+#include <pthread.h>
+#endif
 #include "cs402.h"
 #include "my402list.h"
 
+#ifdef MY402LIST_STATS
+typedef enum {
+    MY402LIST_OP_LENGTH, MY402LIST_OP_EMPTY,
+    MY402LIST_OP_APPEND, MY402LIST_OP_PREPEND, MY402LIST_OP_UNLINK, MY402LIST_OP_UNLINKALL,
+    MY402LIST_OP_INSERTAFTER, MY402LIST_OP_INSERTBEFORE,
+    MY402LIST_OP_FIRST, MY402LIST_OP_LAST, MY402LIST_OP_NEXT, MY402LIST_OP_PREV,
+    MY402LIST_OP_FIND, MY402LIST_OP_CONCAT, MY402LIST_OP_SPLICE, MY402LIST_OP_MOVERANGE,
+    MY402LIST_OP_SORT, MY402LIST_OP_DESTROY,
+    MY402LIST_NUM_OPS
+} My402ListOp;
+
+#define MY402LIST_HIST_BUCKETS 32
+
+typedef struct tagMy402ListStats {
+    long calls[MY402LIST_NUM_OPS];
+    int max_members;
+    long find_scans[MY402LIST_HIST_BUCKETS];
+    long traversals[MY402LIST_HIST_BUCKETS];
+    long cur_traversal;     /* elements visited so far by the open traversal, 0 if none */
+} My402ListStats;
+
+// One entry per list ever seen, most recently used first. Entries are never freed,
+// so a pointer returned by Stats() stays valid.
+typedef struct tagMy402ListStatsEntry {
+    My402List *list;
+    struct tagMy402ListStatsEntry *next;
+    My402ListStats stats;
+} My402ListStatsEntry;
+
+static My402ListStatsEntry *stats_table = NULL;
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static My402ListStats stats_lost;  // shared by lists whose entry could not be allocated
+
+// The counters for list, with a new zeroed entry on first use.
+static My402ListStats *Stats(My402List *list) {
+    pthread_mutex_lock(&stats_mutex);
+    My402ListStatsEntry **link = &stats_table;
+    while (*link != NULL && (*link)->list != list) {
+        link = &((*link)->next);
+    }
+    My402ListStatsEntry *entry = *link;
+    if (entry != NULL) {
+        *link = entry->next;
+    } else {
+        entry = calloc(1, sizeof(My402ListStatsEntry));
+        if (entry == NULL) {
+            pthread_mutex_unlock(&stats_mutex);
+            return &stats_lost;
+        }
+        entry->list = list;
+    }
+    entry->next = stats_table;
+    stats_table = entry;
+    pthread_mutex_unlock(&stats_mutex);
+    return &(entry->stats);
+}
+
+static const char *op_names[MY402LIST_NUM_OPS] = {
+    "Length", "Empty", "Append", "Prepend", "Unlink", "UnlinkAll", "InsertAfter", "InsertBefore",
+    "First", "Last", "Next", "Prev", "Find", "Concat", "Splice", "MoveRange", "Sort", "Destroy"
+};
+
+// Histogram bucket for a scan of len elements: 0 for 0, else floor(log2(len)) + 1.
+static int Bucket(long len) {
+    int bucket = len <= 0 ? 0 : 64 - __builtin_clzl((unsigned long) len);
+    return min(bucket, MY402LIST_HIST_BUCKETS - 1);
+}
+
+// Record the open traversal, if any, and start a new one of length start.
+static void EndTraversal(My402List *list, long start) {
+    My402ListStats *stats = Stats(list);
+    if (stats->cur_traversal > 0) {
+        stats->traversals[Bucket(stats->cur_traversal)]++;
+    }
+    stats->cur_traversal = start;
+}
+
+static void TrackPeak(My402List *list) {
+    My402ListStats *stats = Stats(list);
+    stats->max_members = max(stats->max_members, list->num_members);
+}
+
+#define COUNT(list, op) (Stats(list)->calls[MY402LIST_OP_##op]++)
+#define TRACK_PEAK(list) TrackPeak(list)
+#define COUNT_FIND_SCAN(list, len) (Stats(list)->find_scans[Bucket(len)]++)
+#define TRAVERSE_START(list, elem) EndTraversal(list, (elem) != NULL)
+#define TRAVERSE_STEP(list, elem) ((elem) != NULL ? (void) Stats(list)->cur_traversal++ : EndTraversal(list, 0))
+#else
+#define COUNT(list, op)
+#define TRACK_PEAK(list)
+#define COUNT_FIND_SCAN(list, len) ((void) (len))
+#define TRAVERSE_START(list, elem)
+#define TRAVERSE_STEP(list, elem)
+#endif
+
 int My402ListLength(My402List *list) {
+    COUNT(list, LENGTH);
     return list->num_members;
 }
 
 int My402ListEmpty(My402List *list) {
+    COUNT(list, EMPTY);
     return list->num_members <= 0;
 }
 
-int My402ListAppend(My402List *list, void *obj) {
+// Link a new element for obj in after prev, which may be the anchor.
+static int LinkAfter(My402List *list, void *obj, My402ListElem *prev) {
     My402ListElem *elem = malloc(sizeof(My402ListElem));
     if (elem == NULL) {
         return FALSE;
     }
+    My402ListElem *next = prev->next;
     elem->obj = obj;
-    if (My402ListEmpty(list)) {
-        (list->anchor).next = elem;
-        (list->anchor).prev = elem;
-        elem->next = &(list->anchor);
-        elem->prev = &(list->anchor);
-    } else {
-        My402ListElem *last = My402ListLast(list);
-        elem->next = &(list->anchor);
-        (list->anchor).prev = elem;
-        elem->prev = last;
-        last->next = elem;
-    }
+    elem->next = next;
+    elem->prev = prev;
+    prev->next = elem;
+    next->prev = elem;
     list->num_members++;
+    TRACK_PEAK(list);
     return TRUE;
 }
 
+int My402ListAppend(My402List *list, void *obj) {
+    COUNT(list, APPEND);
+    return LinkAfter(list, obj, (list->anchor).prev);
+}
+
 int My402ListPrepend(My402List *list, void *obj) {
-    My402ListElem *elem = malloc(sizeof(My402ListElem));
-    if (elem == NULL) {
-        return FALSE;
-    }
-    elem->obj = obj;
-    if (My402ListEmpty(list)) {
-        (list->anchor).next = elem;
-        (list->anchor).prev = elem;
-        elem->next = &(list->anchor);
-        elem->prev = &(list->anchor);
-    } else {
-        My402ListElem *first = My402ListFirst(list);
-        elem->next = first;
-        first->prev = elem;
-        elem->prev = &(list->anchor);
-        (list->anchor).next = elem;
-    }
-    list->num_members++;
-    return TRUE;
+    COUNT(list, PREPEND);
+    return LinkAfter(list, obj, &(list->anchor));
 }
 
 void My402ListUnlink(My402List *list, My402ListElem *elem) {
-    if (My402ListEmpty(list)) {
+    COUNT(list, UNLINK);
+    if (list->num_members <= 0) {
         return;
     }
     My402ListElem *prev = elem->prev;
@@ -69,81 +153,240 @@ void My402ListUnlink(My402List *list, My402ListElem *elem) {
     list->num_members--;
 }
 
-void My402ListUnlinkAll(My402List *list) {
-    if (My402ListEmpty(list)) {
-        return;
-    }
-    for (My402ListElem *elem = My402ListFirst(list); elem != NULL;) {
-        My402ListElem *next = My402ListNext(list, elem);
-        My402ListUnlink(list, elem);
+// Free every element in one pass over the next pointers, calling destructor (if any)
+// on each obj.
+static void ReleaseAll(My402List *list, void (*destructor)(void*)) {
+    My402ListElem *elem = (list->anchor).next;
+    while (elem != &(list->anchor)) {
+        My402ListElem *next = elem->next;
+        if (destructor != NULL) {
+            destructor(elem->obj);
+        }
+        free(elem);
         elem = next;
     }
+    list->num_members = 0;
+    (list->anchor).next = &(list->anchor);
+    (list->anchor).prev = &(list->anchor);
+}
+
+void My402ListUnlinkAll(My402List *list) {
+    COUNT(list, UNLINKALL);
+    ReleaseAll(list, NULL);
+}
+
+void My402ListDestroy(My402List *list, void (*destructor)(void*)) {
+    COUNT(list, DESTROY);
+    ReleaseAll(list, destructor);
 }
 
 int My402ListInsertAfter(My402List *list, void *obj, My402ListElem *elem) {
-    if (elem == NULL) {
-        return My402ListAppend(list, obj);
-    }
-    My402ListElem *item = malloc(sizeof(My402ListElem));
-    if (item == NULL) {
-        return FALSE;
-    }
-    item->obj = obj;
-    My402ListElem *next = elem->next;
-    item->next = next;
-    item->prev = elem;
-    elem->next = item;
-    next->prev = item;
-    list->num_members++;
-    return TRUE;
+    COUNT(list, INSERTAFTER);
+    return LinkAfter(list, obj, elem == NULL ? (list->anchor).prev : elem);
 }
 
 int My402ListInsertBefore(My402List *list, void *obj, My402ListElem *elem) {
-    if (elem == NULL) {
-        return My402ListPrepend(list, obj);
-    }
-    My402ListElem *item = malloc(sizeof(My402ListElem));
-    if (item == NULL) {
-        return FALSE;
-    }
-    item->obj = obj;
-    My402ListElem *prev = elem->prev;
-    item->next = elem;
-    item->prev = prev;
-    elem->prev = item;
-    prev->next = item;
-    list->num_members++;
-    return TRUE;
+    COUNT(list, INSERTBEFORE);
+    return LinkAfter(list, obj, elem == NULL ? &(list->anchor) : elem->prev);
 }
 
 My402ListElem *My402ListFirst(My402List *list) {
-    return My402ListEmpty(list) ? NULL : (list->anchor).next;
+    COUNT(list, FIRST);
+    My402ListElem *elem = list->num_members <= 0 ? NULL : (list->anchor).next;
+    TRAVERSE_START(list, elem);
+    return elem;
 }
 
 My402ListElem *My402ListLast(My402List *list) {
-    return My402ListEmpty(list) ? NULL : (list->anchor).prev;
+    COUNT(list, LAST);
+    My402ListElem *elem = list->num_members <= 0 ? NULL : (list->anchor).prev;
+    TRAVERSE_START(list, elem);
+    return elem;
 }
 
 My402ListElem *My402ListNext(My402List *list, My402ListElem *elem) {
-    return elem == My402ListLast(list) ? NULL : elem->next;
+    COUNT(list, NEXT);
+    My402ListElem *next = elem->next == &(list->anchor) ? NULL : elem->next;
+    TRAVERSE_STEP(list, next);
+    return next;
 }
 
 My402ListElem *My402ListPrev(My402List *list, My402ListElem *elem) {
-    return elem == My402ListFirst(list) ? NULL : elem->prev;
+    COUNT(list, PREV);
+    My402ListElem *prev = elem->prev == &(list->anchor) ? NULL : elem->prev;
+    TRAVERSE_STEP(list, prev);
+    return prev;
 }
 
 My402ListElem *My402ListFind(My402List *list, void *obj) {
-    for (My402ListElem *elem = My402ListFirst(list); elem != NULL; elem = My402ListNext(list, elem)) {
+    COUNT(list, FIND);
+    long scanned = 0;
+    for (My402ListElem *elem = (list->anchor).next; elem != &(list->anchor); elem = elem->next) {
+        scanned++;
         if (elem->obj == obj) {
+            COUNT_FIND_SCAN(list, scanned);
             return elem;
         }
     }
+    COUNT_FIND_SCAN(list, scanned);
     return NULL;
 }
 
+static int MoveRange(My402List *list, My402ListElem *elem, My402List *src, My402ListElem *first, My402ListElem *last, int count);
+
+static int SpliceAll(My402List *list, My402ListElem *elem, My402List *src) {
+    if (src->num_members <= 0) {
+        return TRUE;
+    }
+    return MoveRange(list, elem, src, (src->anchor).next, (src->anchor).prev, src->num_members);
+}
+
+int My402ListConcat(My402List *list, My402List *src) {
+    COUNT(list, CONCAT);
+    return SpliceAll(list, NULL, src);
+}
+
+int My402ListSplice(My402List *list, My402ListElem *elem, My402List *src) {
+    COUNT(list, SPLICE);
+    return SpliceAll(list, elem, src);
+}
+
+int My402ListMoveRange(My402List *list, My402ListElem *elem, My402List *src, My402ListElem *first, My402ListElem *last, int count) {
+    COUNT(list, MOVERANGE);
+    return MoveRange(list, elem, src, first, last, count);
+}
+
+static int MoveRange(My402List *list, My402ListElem *elem, My402List *src, My402ListElem *first, My402ListElem *last, int count) {
+    if (count <= 0) {
+        count = 1;
+        for (My402ListElem *cur = first; cur != last; cur = cur->next) {
+            count++;
+        }
+    }
+    // Cut first..last out of src.
+    first->prev->next = last->next;
+    last->next->prev = first->prev;
+    src->num_members -= count;
+    // Link it in after elem, or at the end.
+    My402ListElem *prev = elem == NULL ? (list->anchor).prev : elem;
+    My402ListElem *next = prev->next;
+    prev->next = first;
+    first->prev = prev;
+    last->next = next;
+    next->prev = last;
+    list->num_members += count;
+    TRACK_PEAK(list);
+    return TRUE;
+}
+
+void My402ListSort(My402List *list, int (*cmp)(void*, void*), void (*dup)(void*, void*)) {
+    COUNT(list, SORT);
+    if (list->num_members < 2) {
+        return;
+    }
+    // Sort as a NULL-terminated singly linked list, then restore prev and the anchor.
+    My402ListElem *head = (list->anchor).next;
+    (list->anchor).prev->next = NULL;
+    for (int run = 1;; run *= 2) {
+        My402ListElem *p = head;
+        My402ListElem *tail = NULL;
+        int merges = 0;
+        head = NULL;
+        while (p != NULL) {
+            merges++;
+            My402ListElem *q = p;
+            int psize = 0;
+            for (int i = 0; i < run && q != NULL; i++) {
+                psize++;
+                q = q->next;
+            }
+            int qsize = run;
+            while (psize > 0 || (qsize > 0 && q != NULL)) {
+                My402ListElem *elem;
+                // Take from the left run on ties to keep the sort stable.
+                if (psize == 0) {
+                    elem = q;
+                    q = q->next;
+                    qsize--;
+                } else if (qsize == 0 || q == NULL || cmp(p->obj, q->obj) <= 0) {
+                    elem = p;
+                    p = p->next;
+                    psize--;
+                } else {
+                    elem = q;
+                    q = q->next;
+                    qsize--;
+                }
+                if (tail == NULL) {
+                    head = elem;
+                } else {
+                    tail->next = elem;
+                }
+                tail = elem;
+            }
+            p = q;
+        }
+        tail->next = NULL;
+        if (merges <= 1) {
+            break;
+        }
+    }
+    My402ListElem *prev = &(list->anchor);
+    for (My402ListElem *elem = head; elem != NULL; elem = elem->next) {
+        elem->prev = prev;
+        prev->next = elem;
+        if (dup != NULL && prev != &(list->anchor) && cmp(prev->obj, elem->obj) == 0) {
+            dup(prev->obj, elem->obj);
+        }
+        prev = elem;
+    }
+    prev->next = &(list->anchor);
+    (list->anchor).prev = prev;
+}
+
 int My402ListInit(My402List *list) {
     list->num_members = 0;
     (list->anchor).next = &(list->anchor);
     (list->anchor).prev = &(list->anchor);
+#ifdef MY402LIST_STATS
+    memset(Stats(list), 0, sizeof(My402ListStats));
+#endif
     return TRUE;
 }
+
+#ifdef MY402LIST_STATS
+static void PrintHistogram(FILE *fp, const char *label, long *hist) {
+    fprintf(fp, "    %s:", label);
+    for (int b = 0; b < MY402LIST_HIST_BUCKETS; b++) {
+        if (hist[b] == 0) {
+            continue;
+        }
+        long low = b == 0 ? 0 : 1L << (b - 1);
+        long high = b == 0 ? 0 : (1L << b) - 1;
+        if (low == high) {
+            fprintf(fp, " %ld=%ld", low, hist[b]);
+        } else {
+            fprintf(fp, " %ld-%ld=%ld", low, high, hist[b]);
+        }
+    }
+    fprintf(fp, "\n");
+}
+#endif
+
+void My402ListStatsPrint(My402List *list, const char *name, FILE *fp) {
+#ifdef MY402LIST_STATS
+    EndTraversal(list, 0);
+    TRACK_PEAK(list);
+    My402ListStats *stats = Stats(list);
+    fprintf(fp, "My402List %s: num_members=%d max_members=%d\n", name, list->num_members, stats->max_members);
+    fprintf(fp, "    calls:");
+    for (int op = 0; op < MY402LIST_NUM_OPS; op++) {
+        if (stats->calls[op] != 0) {
+            fprintf(fp, " %s=%ld", op_names[op], stats->calls[op]);
+        }
+    }
+    fprintf(fp, "\n");
+    PrintHistogram(fp, "Find scan lengths", stats->find_scans);
+    PrintHistogram(fp, "traversal lengths", stats->traversals);
+#endif
+}
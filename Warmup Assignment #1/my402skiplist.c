@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "cs402.h"
+#include "my402list.h"
+#include "my402skiplist.h"
+
+static void *Obj(My402SkipNode *node) {
+    return node->elem.obj;
+}
+
+// Each extra lane is kept with probability 1/4.
+static int RandomLanes(My402SkipList *sl) {
+    int lanes = 0;
+    while (lanes < MY402SKIPLIST_MAX_LANES) {
+        sl->seed ^= sl->seed << 13;
+        sl->seed ^= sl->seed >> 17;
+        sl->seed ^= sl->seed << 5;
+        if ((sl->seed & 3) != 0) {
+            break;
+        }
+        lanes++;
+    }
+    return lanes;
+}
+
+// For every lane, find the last node that goes before key (NULL means the head), and
+// return the first level 0 element that does not. With after_equal set, nodes equal to
+// key count as going before it.
+static My402ListElem *Search(My402SkipList *sl, void *key, int after_equal, My402SkipNode **prev) {
+    int bound = after_equal ? 0 : -1;
+    My402SkipNode *cur = NULL;
+    for (int lane = sl->num_lanes; lane >= 1; lane--) {
+        My402SkipNode *next = cur == NULL ? sl->head[lane - 1] : cur->lanes[lane - 1];
+        while (next != NULL && sl->cmp(Obj(next), key) <= bound) {
+            cur = next;
+            next = cur->lanes[lane - 1];
+        }
+        prev[lane - 1] = cur;
+    }
+    My402ListElem *anchor = &(sl->list.anchor);
+    My402ListElem *elem = cur == NULL ? anchor->next : cur->elem.next;
+    while (elem != anchor && sl->cmp(elem->obj, key) <= bound) {
+        elem = elem->next;
+    }
+    return elem;
+}
+
+int My402SkipListInit(My402SkipList *sl, int (*cmp)(void*, void*)) {
+    if (!My402ListInit(&(sl->list))) {
+        return FALSE;
+    }
+    sl->cmp = cmp;
+    sl->num_lanes = 0;
+    memset(sl->head, 0, sizeof(sl->head));
+    sl->seed = 2463534242U;
+    return TRUE;
+}
+
+int My402SkipListInsert(My402SkipList *sl, void *obj, void **dup) {
+    My402SkipNode *prev[MY402SKIPLIST_MAX_LANES];
+    My402ListElem *at = Search(sl, obj, dup == NULL, prev);
+    if (dup != NULL) {
+        *dup = NULL;
+        if (at != &(sl->list.anchor) && sl->cmp(at->obj, obj) == 0) {
+            *dup = at->obj;
+            return FALSE;
+        }
+    }
+    int lanes = RandomLanes(sl);
+    My402SkipNode *node = malloc(sizeof(My402SkipNode) + lanes * sizeof(My402SkipNode*));
+    if (node == NULL) {
+        return FALSE;
+    }
+    node->elem.obj = obj;
+    node->num_lanes = lanes;
+    for (; sl->num_lanes < lanes; sl->num_lanes++) {
+        prev[sl->num_lanes] = NULL;
+    }
+    for (int i = 0; i < lanes; i++) {
+        My402SkipNode **link = prev[i] == NULL ? &(sl->head[i]) : &(prev[i]->lanes[i]);
+        node->lanes[i] = *link;
+        *link = node;
+    }
+    // Level 0: link in front of at.
+    node->elem.next = at;
+    node->elem.prev = at->prev;
+    at->prev->next = &(node->elem);
+    at->prev = &(node->elem);
+    sl->list.num_members++;
+    return TRUE;
+}
+
+My402ListElem *My402SkipListFind(My402SkipList *sl, void *key) {
+    My402SkipNode *prev[MY402SKIPLIST_MAX_LANES];
+    My402ListElem *elem = Search(sl, key, FALSE, prev);
+    if (elem == &(sl->list.anchor) || sl->cmp(elem->obj, key) != 0) {
+        return NULL;
+    }
+    return elem;
+}
+
+void My402SkipListUnlink(My402SkipList *sl, My402ListElem *elem) {
+    My402SkipNode *node = (My402SkipNode*) elem;
+    if (node->num_lanes > 0) {
+        My402SkipNode *prev[MY402SKIPLIST_MAX_LANES];
+        Search(sl, Obj(node), FALSE, prev);
+        for (int i = 0; i < node->num_lanes; i++) {
+            // Equal keys may sit in front of node on this lane.
+            My402SkipNode **link = prev[i] == NULL ? &(sl->head[i]) : &(prev[i]->lanes[i]);
+            while (*link != node) {
+                link = &((*link)->lanes[i]);
+            }
+            *link = node->lanes[i];
+        }
+        while (sl->num_lanes > 0 && sl->head[sl->num_lanes - 1] == NULL) {
+            sl->num_lanes--;
+        }
+    }
+    elem->prev->next = elem->next;
+    elem->next->prev = elem->prev;
+    sl->list.num_members--;
+    free(node);
+}
+
+void My402SkipListDestroy(My402SkipList *sl, void (*destructor)(void*)) {
+    My402ListElem *elem = sl->list.anchor.next;
+    while (elem != &(sl->list.anchor)) {
+        My402ListElem *next = elem->next;
+        if (destructor != NULL) {
+            destructor(elem->obj);
+        }
+        free(elem);
+        elem = next;
+    }
+    My402SkipListInit(sl, sl->cmp);
+}
@@ -0,0 +1,48 @@
+#ifndef _MY402SKIPLIST_H_
+#define _MY402SKIPLIST_H_
+
+#include "cs402.h"
+#include "my402list.h"
+
+/*
+ * Ordered container whose level 0 is an ordinary My402List, kept sorted by
+ * cmp.  Each node also gets a random number of forward "express lanes"
+ * (1 in 4 nodes reach lane 1, 1 in 16 lane 2, ...), so insert, lookup and
+ * duplicate detection take expected O(log n) compares instead of a scan.
+ *
+ * The "list" member can be read with the usual My402ListFirst/Next/...
+ * calls and My402ListElem->obj, but must only be changed through the
+ * My402SkipList functions, since the nodes carry lanes the list does not
+ * know about.
+ */
+#define MY402SKIPLIST_MAX_LANES 24
+
+typedef struct tagMy402SkipNode {
+    My402ListElem elem;     /* must come first; level 0 link */
+    int num_lanes;
+    struct tagMy402SkipNode *lanes[];   /* lanes[i] is the next node on lane i+1 */
+} My402SkipNode;
+
+typedef struct tagMy402SkipList {
+    My402List list;
+    int (*cmp)(void*, void*);
+    int num_lanes;          /* lanes in use */
+    My402SkipNode *head[MY402SKIPLIST_MAX_LANES];
+    unsigned int seed;
+} My402SkipList;
+
+extern int  My402SkipListInit(My402SkipList*, int (*cmp)(void*, void*));
+
+/*
+ * Insert obj in order.  If dup is NULL, obj goes after any objects that
+ * compare equal to it.  Otherwise an equal object makes the insert fail:
+ * *dup is set to it and FALSE is returned.  On allocation failure FALSE is
+ * returned with *dup set to NULL.
+ */
+extern int  My402SkipListInsert(My402SkipList*, void *obj, void **dup);
+
+extern My402ListElem *My402SkipListFind(My402SkipList*, void *key);
+extern void My402SkipListUnlink(My402SkipList*, My402ListElem*);
+extern void My402SkipListDestroy(My402SkipList*, void (*destructor)(void*));
+
+#endif /*_MY402SKIPLIST_H_*/
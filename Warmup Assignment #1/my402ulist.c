@@ -0,0 +1,232 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "cs402.h"
+#include "my402ulist.h"
+
+int My402UListLength(My402UList *list) {
+    return list->num_members;
+}
+
+int My402UListEmpty(My402UList *list) {
+    return list->num_members <= 0;
+}
+
+// Allocate an empty chunk and link it in after prev, or at the front if prev is NULL.
+static My402UListChunk *NewChunk(My402UList *list, My402UListChunk *prev) {
+    void *mem = NULL;
+    if (posix_memalign(&mem, 64, sizeof(My402UListChunk)) != 0) {
+        return NULL;
+    }
+    My402UListChunk *chunk = (My402UListChunk*) mem;
+    chunk->num_objs = 0;
+    chunk->prev = prev;
+    chunk->next = prev == NULL ? list->first : prev->next;
+    if (chunk->next == NULL) {
+        list->last = chunk;
+    } else {
+        chunk->next->prev = chunk;
+    }
+    if (prev == NULL) {
+        list->first = chunk;
+    } else {
+        prev->next = chunk;
+    }
+    list->num_chunks++;
+    return chunk;
+}
+
+static void FreeChunk(My402UList *list, My402UListChunk *chunk) {
+    if (chunk->prev == NULL) {
+        list->first = chunk->next;
+    } else {
+        chunk->prev->next = chunk->next;
+    }
+    if (chunk->next == NULL) {
+        list->last = chunk->prev;
+    } else {
+        chunk->next->prev = chunk->prev;
+    }
+    list->num_chunks--;
+    free(chunk);
+}
+
+// Insert obj so that it ends up at pos, splitting the chunk if it is full.
+// On return pos holds where obj actually went.
+static int InsertAt(My402UList *list, void *obj, My402UListPos *pos) {
+    My402UListChunk *chunk = pos->chunk;
+    int index = pos->index;
+    if (chunk->num_objs == MY402ULIST_CHUNK_OBJS) {
+        My402UListChunk *half = NewChunk(list, chunk);
+        if (half == NULL) {
+            return FALSE;
+        }
+        int keep = chunk->num_objs / 2;
+        half->num_objs = chunk->num_objs - keep;
+        memcpy(half->objs, chunk->objs + keep, half->num_objs * sizeof(void*));
+        chunk->num_objs = keep;
+        if (index > keep) {
+            chunk = half;
+            index -= keep;
+        }
+    }
+    memmove(chunk->objs + index + 1, chunk->objs + index, (chunk->num_objs - index) * sizeof(void*));
+    chunk->objs[index] = obj;
+    chunk->num_objs++;
+    list->num_members++;
+    pos->chunk = chunk;
+    pos->index = index;
+    return TRUE;
+}
+
+int My402UListAppend(My402UList *list, void *obj) {
+    My402UListChunk *chunk = list->last;
+    if (chunk == NULL || chunk->num_objs == MY402ULIST_CHUNK_OBJS) {
+        chunk = NewChunk(list, list->last);
+        if (chunk == NULL) {
+            return FALSE;
+        }
+    }
+    chunk->objs[chunk->num_objs++] = obj;
+    list->num_members++;
+    return TRUE;
+}
+
+int My402UListPrepend(My402UList *list, void *obj) {
+    My402UListChunk *chunk = list->first;
+    if (chunk == NULL || chunk->num_objs == MY402ULIST_CHUNK_OBJS) {
+        chunk = NewChunk(list, NULL);
+        if (chunk == NULL) {
+            return FALSE;
+        }
+    }
+    My402UListPos pos = { chunk, 0 };
+    return InsertAt(list, obj, &pos);
+}
+
+// pos is left at the element that followed the removed one (chunk NULL at the end).
+void My402UListUnlink(My402UList *list, My402UListPos *pos) {
+    My402UListChunk *chunk = pos->chunk;
+    int index = pos->index;
+    if (My402UListEmpty(list) || chunk == NULL) {
+        return;
+    }
+    chunk->num_objs--;
+    memmove(chunk->objs + index, chunk->objs + index + 1, (chunk->num_objs - index) * sizeof(void*));
+    list->num_members--;
+    if (chunk->num_objs == 0) {
+        pos->chunk = chunk->next;
+        pos->index = 0;
+        FreeChunk(list, chunk);
+        return;
+    }
+    // Fold a sparse chunk into its successor's objects so scans stay dense.
+    My402UListChunk *next = chunk->next;
+    if (next != NULL && chunk->num_objs < MY402ULIST_CHUNK_OBJS / 4 && chunk->num_objs + next->num_objs <= MY402ULIST_CHUNK_OBJS) {
+        memcpy(chunk->objs + chunk->num_objs, next->objs, next->num_objs * sizeof(void*));
+        chunk->num_objs += next->num_objs;
+        FreeChunk(list, next);
+    }
+    if (index < chunk->num_objs) {
+        pos->chunk = chunk;
+        pos->index = index;
+    } else {
+        pos->chunk = chunk->next;
+        pos->index = 0;
+    }
+}
+
+void My402UListUnlinkAll(My402UList *list) {
+    My402UListChunk *chunk = list->first;
+    while (chunk != NULL) {
+        My402UListChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    My402UListInit(list);
+}
+
+// pos keeps referring to the same element after the insert.
+int My402UListInsertAfter(My402UList *list, void *obj, My402UListPos *pos) {
+    if (pos == NULL || pos->chunk == NULL) {
+        return My402UListAppend(list, obj);
+    }
+    My402UListPos at = { pos->chunk, pos->index + 1 };
+    if (!InsertAt(list, obj, &at)) {
+        return FALSE;
+    }
+    *pos = at;
+    My402UListPrev(list, pos);
+    return TRUE;
+}
+
+// pos keeps referring to the same element after the insert.
+int My402UListInsertBefore(My402UList *list, void *obj, My402UListPos *pos) {
+    if (pos == NULL || pos->chunk == NULL) {
+        return My402UListPrepend(list, obj);
+    }
+    My402UListPos at = *pos;
+    if (!InsertAt(list, obj, &at)) {
+        return FALSE;
+    }
+    *pos = at;
+    My402UListNext(list, pos);
+    return TRUE;
+}
+
+void *My402UListFirst(My402UList *list, My402UListPos *pos) {
+    pos->chunk = list->first;
+    pos->index = 0;
+    return pos->chunk == NULL ? NULL : pos->chunk->objs[0];
+}
+
+void *My402UListLast(My402UList *list, My402UListPos *pos) {
+    pos->chunk = list->last;
+    pos->index = pos->chunk == NULL ? 0 : pos->chunk->num_objs - 1;
+    return pos->chunk == NULL ? NULL : pos->chunk->objs[pos->index];
+}
+
+void *My402UListNext(My402UList *list, My402UListPos *pos) {
+    if (++pos->index >= pos->chunk->num_objs) {
+        pos->chunk = pos->chunk->next;
+        pos->index = 0;
+    }
+    return pos->chunk == NULL ? NULL : pos->chunk->objs[pos->index];
+}
+
+void *My402UListPrev(My402UList *list, My402UListPos *pos) {
+    if (--pos->index < 0) {
+        pos->chunk = pos->chunk->prev;
+        pos->index = pos->chunk == NULL ? 0 : pos->chunk->num_objs - 1;
+    }
+    return pos->chunk == NULL ? NULL : pos->chunk->objs[pos->index];
+}
+
+int My402UListFind(My402UList *list, void *obj, My402UListPos *pos) {
+    for (My402UListChunk *chunk = list->first; chunk != NULL; chunk = chunk->next) {
+        for (int i = 0; i < chunk->num_objs; i++) {
+            if (chunk->objs[i] == obj) {
+                pos->chunk = chunk;
+                pos->index = i;
+                return TRUE;
+            }
+        }
+    }
+    return FALSE;
+}
+
+My402UListChunk *My402UListFirstChunk(My402UList *list) {
+    return list->first;
+}
+
+My402UListChunk *My402UListNextChunk(My402UList *list, My402UListChunk *chunk) {
+    return chunk->next;
+}
+
+int My402UListInit(My402UList *list) {
+    list->num_members = 0;
+    list->num_chunks = 0;
+    list->first = NULL;
+    list->last = NULL;
+    return TRUE;
+}
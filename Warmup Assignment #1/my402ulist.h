@@ -0,0 +1,63 @@
+#ifndef _MY402ULIST_H_
+#define _MY402ULIST_H_
+
+#include "cs402.h"
+
+/*
+ * Unrolled companion to My402List for scan-heavy lists.  Objects are stored
+ * MY402ULIST_CHUNK_OBJS at a time in 256-byte, cache-line-aligned chunks, so
+ * a full scan walks contiguous memory and follows one pointer per chunk
+ * instead of one per element.
+ *
+ * Positions are (chunk, index) pairs held in a My402UListPos.  A position
+ * stays valid until the list is modified; My402UListUnlink() and the insert
+ * functions update the position passed to them and invalidate all others.
+ */
+#define MY402ULIST_CHUNK_BYTES 256
+#define MY402ULIST_CHUNK_OBJS ((MY402ULIST_CHUNK_BYTES - 2 * sizeof(void*) - 2 * sizeof(int)) / sizeof(void*))
+
+typedef struct tagMy402UListChunk {
+    struct tagMy402UListChunk *next;
+    struct tagMy402UListChunk *prev;
+    int num_objs;
+    int unused;
+    void *objs[MY402ULIST_CHUNK_OBJS];
+} My402UListChunk;
+
+typedef struct tagMy402UList {
+    int num_members;
+    int num_chunks;
+    My402UListChunk *first;
+    My402UListChunk *last;
+} My402UList;
+
+typedef struct tagMy402UListPos {
+    My402UListChunk *chunk;
+    int index;
+} My402UListPos;
+
+extern int  My402UListLength(My402UList*);
+extern int  My402UListEmpty(My402UList*);
+
+extern int  My402UListAppend(My402UList*, void*);
+extern int  My402UListPrepend(My402UList*, void*);
+extern void My402UListUnlink(My402UList*, My402UListPos*);
+extern void My402UListUnlinkAll(My402UList*);
+extern int  My402UListInsertAfter(My402UList*, void*, My402UListPos*);
+extern int  My402UListInsertBefore(My402UList*, void*, My402UListPos*);
+
+/* These return the object at the new position, or NULL past either end. */
+extern void *My402UListFirst(My402UList*, My402UListPos*);
+extern void *My402UListLast(My402UList*, My402UListPos*);
+extern void *My402UListNext(My402UList*, My402UListPos*);
+extern void *My402UListPrev(My402UList*, My402UListPos*);
+
+extern int  My402UListFind(My402UList*, void*, My402UListPos*);
+
+/* Chunk iteration: visit chunk->objs[0 .. chunk->num_objs - 1] per chunk. */
+extern My402UListChunk *My402UListFirstChunk(My402UList*);
+extern My402UListChunk *My402UListNextChunk(My402UList*, My402UListChunk*);
+
+extern int My402UListInit(My402UList*);
+
+#endif /*_MY402ULIST_H_*/
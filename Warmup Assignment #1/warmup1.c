@@ -1,240 +1,1591 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <stdint.h>
+#include <limits.h>
 #include <unistd.h>
 #include <ctype.h>
 #include <time.h>
 #include <locale.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "cs402.h"
 #include "my402list.h"
+#include "my402poollist.h"
 
 FILE *fp;
+My402ListPool pool;
+
+// A regular file is mapped and parsed in place; anything else is read line by line
+// into one reused buffer.
+char *map = NULL;
+size_t map_size = 0;
+struct stat map_stat;       // of the mapped file, taken when it was mapped
+char *line = NULL;
+size_t line_size = 0;
 
 typedef struct {
     char type;
     time_t time;
-    double amount;
+    int64_t cents;
     char description[25];
     int count;
+    int64_t offset;     // of the line in the mapped file; 0 for lines read from a stream
 } Transaction;
 
+MY402POOLLIST_TYPED(TransactionList, Transaction)
+
 void usage(void) {
-    fprintf(stderr, "usage: warmup1 sort [tfile]\n");
+    fprintf(stderr, "usage: warmup1 sort [tfile ...]\n");
+    fprintf(stderr, "       warmup1 sort --bin [binfile]\n");
+    fprintf(stderr, "       warmup1 compile tfile binfile\n");
+    fprintf(stderr, "       warmup1 range start end [tfile]\n");
     exit(1);
 }
 
-void free_list(My402List *list, Transaction *transaction, char *line) {
-    free(transaction);
+// Transactions are read into one array in file order, sorted once by time, and only
+// then put on a My402List for printing.
+Transaction *transactions = NULL;
+int num_transactions = 0;
+
+typedef struct {
+    time_t time;
+    int index;
+} SortKey;
+
+SortKey *sorted = NULL;     // rows[sorted[i].index] is the i-th by time after sort_by_time()
+
+// "warmup1 range" prints only the rows with range_start <= time < range_end, with the
+// balance carried in from the rows before them.
+int ranged = FALSE;
+time_t range_start = 0;
+time_t range_end = 0;
+
+int before_range(time_t time) {
+    return ranged && time < range_start;
+}
+
+int after_range(time_t time) {
+    return ranged && time >= range_end;
+}
+
+int64_t signed_cents(char type, int64_t cents) {
+    return type == '+' ? cents : -cents;
+}
+
+// Streaming mode, for ledgers that do not fit in memory, is turned on by setting the
+// WARMUP1_MEMORY environment variable to a budget in bytes (a K, M or G suffix is
+// allowed). Once that many bytes' worth of rows have been read, they are sorted and
+// spilled to a temporary file as a run of Records, and at the end the runs are merged
+// while printing. Without it every row stays in memory.
+typedef struct {
+    int64_t time;
+    int64_t cents;
+    int32_t count;
+    char type;
+    char description[24];
+    char unused[3];
+} Record;
+
+#define ROW_BYTES (sizeof(Transaction) + 2 * sizeof(SortKey))
+#define MAX_FANIN 64        // runs of one level merged into one of the next
+
+size_t memory_budget = 0;
+int run_rows = INT_MAX;     // rows held in memory before they are spilled
+FILE **runs = NULL;
+int *run_levels = NULL;     // how many merges each run has been through, non-increasing
+int num_runs = 0;
+
+// Index mode, for a ledger that only ever grows at the end, is turned on by setting the
+// WARMUP1_INDEX environment variable to the path of a sidecar index file. The index
+// holds a record per transaction in time order, pointing back at its line, for the
+// first indexed_bytes of the tfile, together with the balance after all of them. A run
+// parses only the bytes after that, merges the new rows into the index and prints from
+// it. If the tfile no longer starts with what was indexed, the index is rebuilt. A tfile
+// whose size, modification time and inode are still those recorded is taken to be
+// unchanged. Any other is checked against a hash of INDEX_CHECKPOINTS blocks spread
+// over the indexed bytes, the first and the last among them, so that checking costs
+// the same however long the ledger grows. An edit that misses every block goes
+// unnoticed.
+typedef struct {
+    char magic[8];
+    uint64_t indexed_bytes;     // whole lines only
+    uint64_t checkpoint_hash;   // FNV-1a of the checkpoint blocks of those
+    int64_t tfile_size;         // of the tfile when the index was written
+    int64_t tfile_mtime;        // in nanoseconds
+    uint64_t tfile_inode;
+    int64_t num_records;
+    int64_t num_lines;
+    int64_t balance;            // after the last record, in cents
+} IndexHeader;
+
+typedef struct {
+    int64_t time;
+    int64_t cents;
+    int64_t offset;
+    int32_t count;
+    char type;
+    char unused[3];
+    int64_t balance;    // after this record, so a range can start anywhere
+} IndexRecord;
+
+#define INDEX_MAGIC "W1INDEX3"
+#define INDEX_CHECKPOINTS 16
+#define INDEX_BLOCK_BYTES 4096
+
+char *index_map = NULL;
+size_t index_size = 0;
+IndexHeader index_header;
+IndexRecord *index_records = NULL;      // points into index_map
+
+// "warmup1 sort" with several tfiles, each normally in time order already, reads them
+// one at a time into shards and merges those. Errors then name the tfile they are in.
+typedef struct {
+    char *name;
+    Transaction *rows;
+    int num_rows;
+    SortKey *order;     // rows[order[i].index] is the i-th by time; NULL if rows are
+    int next;           // next row to merge, in that order
+} Shard;
+
+Shard *shards = NULL;
+int num_shards = 0;
+char *shard_name = NULL;    // of the tfile being read
+
+void error_prefix(void) {
+    if (shard_name != NULL) {
+        fprintf(stderr, "%s: ", shard_name);
+    }
+}
+
+void free_all(TransactionList *list) {
     free(line);
-    for (My402ListElem *elem = My402ListFirst(list); elem != NULL; elem = My402ListNext(list, elem)) {
-        free(elem->obj);
+    if (map != NULL) {
+        munmap(map, map_size);
+    }
+    if (list != NULL) {
+        My402ListStatsPrint(&list->list.list, "ledger", stderr);
+        My402PoolListDestroy(&list->list, NULL);
+    }
+    free(sorted);
+    free(transactions);
+    for (int i = 0; i < num_runs; i++) {
+        fclose(runs[i]);
+    }
+    free(runs);
+    free(run_levels);
+    if (index_map != NULL) {
+        munmap(index_map, index_size);
+    }
+    for (int i = 0; i < num_shards; i++) {
+        free(shards[i].rows);
+        free(shards[i].order);
+    }
+    free(shards);
+    if (fp != NULL) {
+        fclose(fp);
+    }
+}
+
+// For allocations made while sorting or merging, which have no error path to return to.
+void out_of_memory(void) {
+    error_prefix();
+    fprintf(stderr, "Error: Out of memory\n");
+    free_all(NULL);
+    exit(1);
+}
+
+// Stable LSD radix sort of rows[0 .. n-1] by time, a byte per pass. Bytes that are the
+// same in every timestamp are skipped, so real dates take four passes.
+void sort_by_time(Transaction *rows, int n) {
+    SortKey *keys = malloc(max(n, 1) * sizeof(SortKey));
+    SortKey *tmp = malloc(max(n, 1) * sizeof(SortKey));
+    if (keys == NULL || tmp == NULL) {
+        free(keys);
+        free(tmp);
+        out_of_memory();
+    }
+    static int counts[sizeof(time_t)][256];
+    memset(counts, 0, sizeof(counts));
+    for (int i = 0; i < n; i++) {
+        keys[i].time = rows[i].time;
+        keys[i].index = i;
+        for (int b = 0; b < sizeof(time_t); b++) {
+            counts[b][(keys[i].time >> (8 * b)) & 0xff]++;
+        }
+    }
+    for (int b = 0; b < sizeof(time_t); b++) {
+        if (n == 0 || counts[b][(keys[0].time >> (8 * b)) & 0xff] == n) {
+            continue;
+        }
+        int offsets[256];
+        int sum = 0;
+        for (int d = 0; d < 256; d++) {
+            offsets[d] = sum;
+            sum += counts[b][d];
+        }
+        for (int i = 0; i < n; i++) {
+            tmp[offsets[(keys[i].time >> (8 * b)) & 0xff]++] = keys[i];
+        }
+        SortKey *swap = keys;
+        keys = tmp;
+        tmp = swap;
+    }
+    free(tmp);
+    free(sorted);
+    sorted = keys;
+}
+
+void find_duplicate_in_runs(int *first, int *second);
+void merge_full_levels(void);
+int index_lower_bound(time_t time);
+
+// Sort what has been read so far and stop at the first duplicate timestamp. Of all the
+// equal neighbours, report the pair whose later line comes first: that is the duplicate
+// a line-by-line insertion would have run into. This runs before any other error is
+// reported, since a duplicate on an earlier line wins.
+void check_duplicates(void) {
+    int first = 0;
+    int second = 0;
+    if (num_runs > 0) {
+        find_duplicate_in_runs(&first, &second);
+    } else {
+        sort_by_time(transactions, num_transactions);
+        for (int i = 1; i < num_transactions; i++) {
+            Transaction *a = &transactions[sorted[i - 1].index];
+            Transaction *b = &transactions[sorted[i].index];
+            if (a->time == b->time && (second == 0 || b->count < second)) {
+                first = a->count;
+                second = b->count;
+            }
+        }
+        // Indexed lines come before every new one and have no duplicates among them.
+        for (int i = 0; i < num_transactions && index_records != NULL; i++) {
+            int k = index_lower_bound(transactions[i].time);
+            if (k < index_header.num_records && index_records[k].time == transactions[i].time && (second == 0 || transactions[i].count < second)) {
+                first = index_records[k].count;
+                second = transactions[i].count;
+            }
+        }
+    }
+    if (second != 0) {
+        error_prefix();
+        fprintf(stderr, "Error: Duplicate timestamp on line %d and line %d\n", first, second);
+        free_all(NULL);
+        exit(1);
+    }
+}
+
+// The first sorted row at or after time.
+int sorted_lower_bound(time_t time) {
+    int low = 0;
+    int high = num_transactions;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (sorted[mid].time < time) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// The balance after the first n sorted rows. Only a range that does not start at the
+// first row needs it, and it is asked for once, so the rows are simply summed.
+int64_t opening_balance(int n) {
+    int64_t balance = 0;
+    for (int i = 0; i < n; i++) {
+        Transaction *transaction = &transactions[sorted[i].index];
+        balance += signed_cents(transaction->type, transaction->cents);
+    }
+    return balance;
+}
+
+// Parse a time given on the command line: digits only, like a tfile timestamp.
+int parse_time(const char *text, time_t *time) {
+    if (*text == '\0' || strspn(text, "0123456789") != strlen(text) || strlen(text) > 18) {
+        return FALSE;
+    }
+    *time = strtoll(text, NULL, 10);
+    return TRUE;
+}
+
+// Parse a size such as 65536, 512K or 2G.
+size_t parse_size(const char *text) {
+    char *end;
+    errno = 0;
+    double size = strtod(text, &end);
+    switch (toupper((unsigned char) *end)) {
+        case 'G':
+            size *= 1024;
+        case 'M':
+            size *= 1024;
+        case 'K':
+            size *= 1024;
+            end++;
+    }
+    if (errno != 0 || end == text || *end != '\0' || size < 1) {
+        return 0;
+    }
+    return (size_t) size;
+}
+
+FILE *new_run(int level) {
+    FILE *run = tmpfile();
+    FILE **grown_runs = realloc(runs, (num_runs + 1) * sizeof(FILE*));
+    if (grown_runs != NULL) {
+        runs = grown_runs;
+    }
+    int *grown_levels = realloc(run_levels, (num_runs + 1) * sizeof(int));
+    if (grown_levels != NULL) {
+        run_levels = grown_levels;
+    }
+    if (run == NULL || grown_runs == NULL || grown_levels == NULL) {
+        fprintf(stderr, "Error: Cannot create a temporary file\n");
+        if (run != NULL) {
+            fclose(run);
+        }
+        free_all(NULL);
+        exit(1);
+    }
+    runs[num_runs] = run;
+    run_levels[num_runs] = level;
+    num_runs++;
+    return run;
+}
+
+void write_record(FILE *run, Record *record) {
+    if (fwrite(record, sizeof(Record), 1, run) != 1) {
+        fprintf(stderr, "Error: Cannot write a temporary file\n");
+        free_all(NULL);
+        exit(1);
+    }
+}
+
+// Sort rows[0 .. n-1] by time and write them out as a new run.
+void spill(Transaction *rows, int n) {
+    if (n == 0) {
+        return;
+    }
+    sort_by_time(rows, n);
+    FILE *run = new_run(0);
+    for (int i = 0; i < n; i++) {
+        Transaction *transaction = &rows[sorted[i].index];
+        Record record;
+        memset(&record, 0, sizeof(Record));
+        record.time = transaction->time;
+        record.cents = transaction->cents;
+        record.count = transaction->count;
+        record.type = transaction->type;
+        memcpy(record.description, transaction->description, 24);
+        write_record(run, &record);
     }
-    My402ListUnlinkAll(list);
-    fclose(fp);
+    free(sorted);
+    sorted = NULL;
+    merge_full_levels();
 }
 
-Transaction *parse_line(char *line, My402List *list, int count) {
+// Restore the min-heap of run numbers below parent, ordered by each run's head record.
+void sift_down(int *heap, int size, Record *heads, int parent) {
+    #define HEAD_LESS(a, b) (heads[a].time < heads[b].time || (heads[a].time == heads[b].time && heads[a].count < heads[b].count))
+    for (int child; (child = 2 * parent + 1) < size; parent = child) {
+        if (child + 1 < size && HEAD_LESS(heap[child + 1], heap[child])) {
+            child++;
+        }
+        if (!HEAD_LESS(heap[child], heap[parent])) {
+            break;
+        }
+        int tmp = heap[parent];
+        heap[parent] = heap[child];
+        heap[child] = tmp;
+    }
+    #undef HEAD_LESS
+}
+
+// Merge runs[first .. first+n-1] in (time, line) order, calling emit on every record.
+// Lines are unique, so the order is total and does not depend on which run is which.
+void merge_runs(int first, int n, void (*emit)(Record*, void*), void *arg) {
+    Record *heads = malloc(max(n, 1) * sizeof(Record));
+    int *heap = malloc(max(n, 1) * sizeof(int));
+    if (heads == NULL || heap == NULL) {
+        free(heads);
+        free(heap);
+        out_of_memory();
+    }
+    int size = 0;
+    for (int i = 0; i < n; i++) {
+        rewind(runs[first + i]);
+        if (fread(&heads[i], sizeof(Record), 1, runs[first + i]) == 1) {
+            heap[size++] = i;
+        }
+    }
+    for (int i = size / 2 - 1; i >= 0; i--) {
+        sift_down(heap, size, heads, i);
+    }
+    while (size > 0) {
+        int top = heap[0];
+        emit(&heads[top], arg);
+        if (fread(&heads[top], sizeof(Record), 1, runs[first + top]) != 1) {
+            heap[0] = heap[--size];
+        }
+        sift_down(heap, size, heads, 0);
+    }
+    free(heads);
+    free(heap);
+}
+
+void emit_to_run(Record *record, void *arg) {
+    write_record((FILE*) arg, record);
+}
+
+// Whenever the last MAX_FANIN runs are all of one level, merge them into a single run of
+// the next, so every row is merged about log(rows) / log(MAX_FANIN) times and at most
+// MAX_FANIN - 1 runs per level stay open for the final merge.
+void merge_full_levels(void) {
+    while (num_runs >= MAX_FANIN && run_levels[num_runs - MAX_FANIN] == run_levels[num_runs - 1]) {
+        int first = num_runs - MAX_FANIN;
+        int level = run_levels[first];
+        FILE *run = new_run(level + 1);
+        merge_runs(first, MAX_FANIN, emit_to_run, run);
+        for (int i = first; i < num_runs - 1; i++) {
+            fclose(runs[i]);
+        }
+        runs[first] = run;
+        run_levels[first] = level + 1;
+        num_runs = first + 1;
+    }
+}
+
+// Equal timestamps come out of the merge in line order, so the first two lines of each
+// group are the pair to report for it.
+typedef struct {
+    int64_t time;
+    int group_first;
+    int group_size;
+    int first;
+    int second;
+} DuplicateScan;
+
+void emit_duplicate(Record *record, void *arg) {
+    DuplicateScan *scan = (DuplicateScan*) arg;
+    if (scan->group_size > 0 && record->time == scan->time) {
+        if (scan->group_size++ == 1 && (scan->second == 0 || record->count < scan->second)) {
+            scan->first = scan->group_first;
+            scan->second = record->count;
+        }
+        return;
+    }
+    scan->time = record->time;
+    scan->group_first = record->count;
+    scan->group_size = 1;
+}
+
+// Spill whatever is still in memory and look for duplicates across every run.
+void find_duplicate_in_runs(int *first, int *second) {
+    spill(transactions, num_transactions);
+    num_transactions = 0;
+    DuplicateScan scan;
+    memset(&scan, 0, sizeof(DuplicateScan));
+    merge_runs(0, num_runs, emit_duplicate, &scan);
+    *first = scan.first;
+    *second = scan.second;
+}
+
+// Return the next run of non-tab bytes in [*pos, end) and leave *pos just past it, or
+// NULL if there is none. Empty fields are skipped, as strtok(line, "\t") would.
+const char *next_token(const char **pos, const char *end) {
+    const char *p = *pos;
+    while (p < end && *p == '\t') {
+        p++;
+    }
+    if (p == end) {
+        return NULL;
+    }
+    const char *token = p;
+    while (p < end && *p != '\t') {
+        p++;
+    }
+    *pos = p;
+    return token;
+}
+
+enum {
+    PARSE_OK, ERR_LINE_LENGTH, ERR_TYPE, ERR_TIMESTAMP, ERR_TIMESTAMP_LENGTH, ERR_TIMESTAMP_RANGE,
+    ERR_AMOUNT, ERR_DESCRIPTION, ERR_EXTRA_FIELD, ERR_MISSING_FIELD, ERR_MEMORY
+};
+
+// Indexed by the values above; each is printed with the failing line number.
+const char *parse_errors[] = {
+    NULL,
+    "Error: The line %d is longer than 1024 characters\n",
+    "Error: Incorrect type on line %d\n",
+    "Error: Invalid timestamp on line %d\n",
+    "Error: Timestamp exceeds the maximum length on line %d\n",
+    "Error: Timestamp is not in the correct range on line %d\n",
+    "Error: Amount is invalid on line %d\n",
+    "Error: Empty description on line %d\n",
+    "Error: Incorrect file format on line %d\n",
+    "Error: Incorrect file format\n",
+    "Error: Out of memory\n",
+};
+
+// Fill description with the field in [token, end) padded to 24 columns; FALSE if blank.
+int copy_description(const char *token, const char *end, char *description) {
+    memset(description, ' ', 24);
+    const char *c = token;
+    while (c < end && isspace((unsigned char) *c)) {
+        c++;
+    }
+    if (c == end) {
+        return FALSE;
+    }
+    // The last byte of the field is taken to be the newline and left out.
+    memcpy(description, c, min(24, end - 1 - c));
+    description[24] = '\0';
+    return TRUE;
+}
+
+// Parse the line in [line, end), which includes its newline if it has one, without
+// modifying or copying it. Returns PARSE_OK or what is wrong with the line.
+int parse_line(const char *line, const char *end, Transaction *transaction) {
+    const char *nul = memchr(line, '\0', end - line);
+    if (nul != NULL) {
+        end = nul;
+    }
     int num = 0;
-    Transaction *transaction = malloc(sizeof(Transaction));
-    char *token = strtok(line, "\t");
+    const char *pos = line;
+    const char *token;
     int dot = 0;
-    while (token != NULL) {
+    char number[16];
+    while ((token = next_token(&pos, end)) != NULL) {
+        int token_length = pos - token;
         switch (num) {
             case 0:
-                if (strlen(token) != 1 || (*token != '+' && *token != '-')) {
-                    fprintf(stderr, "Error: Incorrect type on line %d\n", count);
-                    free_list(list, transaction, line);
-                    exit(1);
+                if (token_length != 1 || (*token != '+' && *token != '-')) {
+                    return ERR_TYPE;
                 }
                 transaction->type = *token;
                 break;
             case 1:
-                for (char *c = token; *c; c++) {
-                    if (!isdigit(*c)) {
-                        fprintf(stderr, "Error: Invalid timestamp on line %d\n", count);
-                        free_list(list, transaction, line);
-                        exit(1);
+                for (const char *c = token; c < pos; c++) {
+                    if (!isdigit((unsigned char) *c)) {
+                        return ERR_TIMESTAMP;
                     }
                 }
-                if (strlen(token) >= 11) {
-                    fprintf(stderr, "Error: Timestamp exceeds the maximum length on line %d\n", count);
-                    free_list(list, transaction, line);
-                    exit(1);
+                if (token_length >= 11) {
+                    return ERR_TIMESTAMP_LENGTH;
                 }
+                memcpy(number, token, token_length);
+                number[token_length] = '\0';
                 time_t current = time(NULL);
-                time_t timestamp = strtol(token, NULL, 0);
+                time_t timestamp = strtol(number, NULL, 0);
                 if (timestamp < 0 || difftime(current, timestamp) < 0) {
-                    fprintf(stderr, "Error: Timestamp is not in the correct range on line %d\n", count);
-                    free_list(list, transaction, line);
-                    exit(1);
+                    return ERR_TIMESTAMP_RANGE;
                 }
                 transaction->time = timestamp;
                 break;
             case 2:
-                for (char *c = token; *c; c++) {
+                for (const char *c = token; c < pos; c++) {
                     if (*c == '.') {
                         dot++;
-                    } else if (!isdigit(*c)) {
-                        fprintf(stderr, "Error: Amount is invalid on line %d\n", count);
-                        free_list(list, transaction, line);
-                        exit(1);
+                    } else if (!isdigit((unsigned char) *c)) {
+                        return ERR_AMOUNT;
                     }
                 }
                 if (dot != 1) {
-                    fprintf(stderr, "Error: Amount is invalid on line %d\n", count);
-                    free_list(list, transaction, line);
-                    exit(1);
+                    return ERR_AMOUNT;
                 }
-                char *p = strstr(token, ".");
-                if (p - token > 7 || (strlen(p) - 1) != 2) {
-                    fprintf(stderr, "Error: Amount is invalid on line %d\n", count);
-                    free_list(list, transaction, line);
-                    exit(1);
+                const char *p = memchr(token, '.', token_length);
+                if (p - token > 7 || pos - p - 1 != 2) {
+                    return ERR_AMOUNT;
+                }
+                // Digits with a single '.' before the last two, so the cents are exact.
+                transaction->cents = 0;
+                for (const char *c = token; c < pos; c++) {
+                    if (*c != '.') {
+                        transaction->cents = transaction->cents * 10 + (*c - '0');
+                    }
                 }
-                transaction->amount = strtod(token, NULL);
                 break;
             case 3:
-                memset(transaction->description, ' ', 24);
-                char *c = token;
-                while (*c && isspace((unsigned char)*c)) {
-                    c++;
-                }
-                if (!(*c)) {
-                    fprintf(stderr, "Error: Empty description on line %d\n", count);
-                    free_list(list, transaction, line);
-                    exit(1);
+                if (!copy_description(token, pos, transaction->description)) {
+                    return ERR_DESCRIPTION;
                 }
-                strncpy(transaction->description, c, min(24, token + strlen(token) - 1 - c));
-                transaction->description[24] = '\0';
                 break;
             default:
-                fprintf(stderr, "Error: Incorrect file format on line %d\n", count);
-                free_list(list, transaction, line);
-                exit(1);
+                return ERR_EXTRA_FIELD;
         }
-        token = strtok(NULL, "\t");
         num++;
     }
-    free(line);
     if (num != 4) {
-        fprintf(stderr, "Error: Incorrect file format\n");
-        free_list(list, transaction, NULL);
-        exit(1);
+        return ERR_MISSING_FIELD;
     }
-    transaction->count = count;
-    return transaction;
+    return PARSE_OK;
 }
 
-void insertion_sort(My402List *list, Transaction *transaction) {
-    for (My402ListElem *elem = My402ListFirst(list); elem != NULL; elem = My402ListNext(list, elem)) {
-        Transaction *obj = (Transaction*) (elem->obj);
-        if (difftime(transaction->time, obj->time) < 0) {
-            My402ListInsertBefore(list, transaction, elem);
-            return;
-        } else if (difftime(transaction->time, obj->time) == 0) {
-            fprintf(stderr, "Error: Duplicate timestamp on line %d and line %d\n", obj->count, transaction->count);
-            free_list(list, transaction, NULL);
-            exit(1);
+// A stretch of the input, whole lines only, and the transactions parsed from it.
+// Line numbers (and the count of each row) are relative to the start of the chunk
+// until the chunks are merged.
+typedef struct {
+    const char *start;
+    const char *end;
+    Transaction *rows;
+    int num_rows;
+    int max_rows;
+    int num_lines;      // lines seen, including the failing one if error is set
+    int error;
+    pthread_t thread;
+} Chunk;
+
+// Parse one line into the chunk; returns PARSE_OK or why the line is bad.
+int add_line(Chunk *chunk, const char *start, const char *end) {
+    chunk->num_lines++;
+    if (end - start > 1024) {
+        return ERR_LINE_LENGTH;
+    }
+    if (chunk->num_rows == chunk->max_rows) {
+        int max = min(chunk->max_rows == 0 ? 1024 : chunk->max_rows * 2, run_rows);
+        Transaction *grown = realloc(chunk->rows, max * sizeof(Transaction));
+        if (grown == NULL) {
+            return ERR_MEMORY;
+        }
+        chunk->rows = grown;
+        chunk->max_rows = max;
+    }
+    Transaction *transaction = &chunk->rows[chunk->num_rows];
+    int error = parse_line(start, end, transaction);
+    if (error == PARSE_OK) {
+        transaction->count = chunk->num_lines;
+        // A streamed line is in the reused line buffer, not in any mapping.
+        transaction->offset = map == NULL ? 0 : start - map;
+        if (++chunk->num_rows == run_rows) {
+            spill(chunk->rows, chunk->num_rows);
+            chunk->num_rows = 0;
         }
     }
-    // Empty list or append to the end.
-    My402ListAppend(list, transaction);
+    return error;
+}
+
+// Parse the chunk's lines until the end or the first bad one.
+void *parse_chunk(void *arg) {
+    Chunk *chunk = (Chunk*) arg;
+    const char *start = chunk->start;
+    while (start < chunk->end && chunk->error == PARSE_OK) {
+        const char *newline = memchr(start, '\n', chunk->end - start);
+        const char *end = newline == NULL ? chunk->end : newline + 1;
+        chunk->error = add_line(chunk, start, end);
+        start = end;
+    }
+    return NULL;
+}
+
+// Parse files of at least this many bytes on one thread per CPU. The WARMUP1_THREADS
+// environment variable overrides the number of threads for any file size.
+#define PARALLEL_MIN_BYTES (1 << 20)
+#define MAX_THREADS 64
+
+int num_threads(size_t size) {
+    if (memory_budget != 0) {
+        return 1;
+    }
+    char *env = getenv("WARMUP1_THREADS");
+    int n = env != NULL ? atoi(env) : size >= PARALLEL_MIN_BYTES ? sysconf(_SC_NPROCESSORS_ONLN) : 1;
+    return max(1, min(n, MAX_THREADS));
 }
 
+// Split the mapped file from the line at from to the end into up to n chunks at line
+// boundaries and parse them on their own threads. Returns the number of chunks.
+int parse_mapped(Chunk *chunks, int n, const char *from) {
+    const char *map_end = map + map_size;
+    const char *start = from;
+    int num_chunks = 0;
+    if (start == map_end) {
+        memset(&chunks[0], 0, sizeof(Chunk));
+        return 1;
+    }
+    for (int i = 1; i <= n && start < map_end; i++) {
+        const char *end = map_end;
+        if (i < n) {
+            // Cut just after the first newline at or past i/n of the way through.
+            end = from + (map_end - from) / n * i;
+            if (end < start) {
+                end = start;
+            }
+            const char *newline = memchr(end, '\n', map_end - end);
+            end = newline == NULL ? map_end : newline + 1;
+        }
+        memset(&chunks[num_chunks], 0, sizeof(Chunk));
+        chunks[num_chunks].start = start;
+        chunks[num_chunks].end = end;
+        num_chunks++;
+        start = end;
+    }
+    if (num_chunks == 1) {
+        parse_chunk(&chunks[0]);
+        return 1;
+    }
+    for (int i = 0; i < num_chunks; i++) {
+        if (pthread_create(&chunks[i].thread, NULL, parse_chunk, &chunks[i]) != 0) {
+            parse_chunk(&chunks[i]);
+            chunks[i].thread = pthread_self();
+        }
+    }
+    for (int i = 0; i < num_chunks; i++) {
+        if (!pthread_equal(chunks[i].thread, pthread_self())) {
+            pthread_join(chunks[i].thread, NULL);
+        }
+    }
+    return num_chunks;
+}
+
+// Concatenate the chunks' rows into transactions in file order, renumbering their
+// lines, up to and including the first chunk that failed. The lowest failing line
+// therefore wins, as if the file had been read front to back. Returns the number
+// of lines read and sets *error to that chunk's error, if any.
+int merge_chunks(Chunk *chunks, int num_chunks, int *error) {
+    int last = num_chunks - 1;
+    int total = 0;
+    for (int i = 0; i < num_chunks; i++) {
+        total += chunks[i].num_rows;
+        if (chunks[i].error != PARSE_OK) {
+            last = i;
+            break;
+        }
+    }
+    int lines = 0;
+    if (num_chunks == 1) {
+        transactions = chunks[0].rows;
+        lines = chunks[0].num_lines;
+    } else {
+        transactions = malloc(max(total, 1) * sizeof(Transaction));
+        int num_rows = 0;
+        for (int i = 0; i <= last && transactions != NULL; i++) {
+            Transaction *rows = transactions + num_rows;
+            memcpy(rows, chunks[i].rows, chunks[i].num_rows * sizeof(Transaction));
+            for (int j = 0; j < chunks[i].num_rows; j++) {
+                rows[j].count += lines;
+            }
+            num_rows += chunks[i].num_rows;
+            lines += chunks[i].num_lines;
+        }
+        for (int i = 0; i < num_chunks; i++) {
+            free(chunks[i].rows);
+        }
+        if (transactions == NULL) {
+            *error = ERR_MEMORY;
+            return lines;
+        }
+    }
+    num_transactions = total;
+    *error = chunks[last].error;
+    return lines;
+}
+
+// Report a bad line the way a front-to-back read would have: a duplicate timestamp
+// among the lines before it comes first.
+void fail(int error, int count) {
+    check_duplicates();
+    error_prefix();
+    fprintf(stderr, parse_errors[error], count);
+    free_all(NULL);
+    exit(1);
+}
+
+// The date part of ctime(), "Thu Jan  1 1970". ctime() checks the time zone files on
+// every call, which would cost more than the rest of a row; localtime_r() does not.
 void formart_time(time_t time, char *buf) {
-    strcpy(buf, ctime(&time));
-    strncpy(((void*) buf) + 11, ((void*) buf) + 20, 4);
-    buf[15] = '\0';
+    static const char *days = "SunMonTueWedThuFriSat";
+    static const char *months = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    struct tm tm;
+    localtime_r(&time, &tm);
+    snprintf(buf, 26, "%.3s %.3s%3d %d", days + 3 * tm.tm_wday, months + 3 * tm.tm_mon, tm.tm_mday, tm.tm_year + 1900);
 }
 
-void format_money(double amount, char *buf, char type) {
-    char *original = setlocale(LC_NUMERIC, NULL);
+// The LC_NUMERIC conventions of the user's locale, captured once by init_money_format()
+// so that formatting a field does not switch locales.
+char decimal_point[8] = ".";
+char thousands_sep[8] = "";
+char grouping[16] = "";
+
+void init_money_format(void) {
+    char *original = strdup(setlocale(LC_NUMERIC, NULL));
     setlocale(LC_NUMERIC, "");
-    if (amount < 0 || type == '-') {
-        amount = amount < 0 ? amount * -1 : amount;
-        if (amount >= 10000000) {
-            sprintf(buf, "(?,???,???.\?\?)");
-        } else {
-            sprintf(buf, "(%'12.2f)", amount);
+    struct lconv *conv = localeconv();
+    snprintf(decimal_point, sizeof(decimal_point), "%s", conv->decimal_point);
+    snprintf(thousands_sep, sizeof(thousands_sep), "%s", conv->thousands_sep);
+    snprintf(grouping, sizeof(grouping), "%s", conv->grouping);
+    setlocale(LC_NUMERIC, original);
+    free(original);
+}
+
+// Write cents (>= 0) as printf("%'.2f") would in the captured locale, ending at end.
+// Returns where the number starts.
+char *format_cents(int64_t cents, char *end) {
+    char *p = end;
+    *--p = '0' + cents % 10;
+    *--p = '0' + cents / 10 % 10;
+    p -= strlen(decimal_point);
+    memcpy(p, decimal_point, strlen(decimal_point));
+    int64_t units = cents / 100;
+    const char *group = grouping;
+    int run = 0;
+    do {
+        // Each grouping byte is the size of the next group to the left; the last one
+        // repeats, and CHAR_MAX (or none at all) stops the grouping.
+        if (*group > 0 && *group != CHAR_MAX && run == *group) {
+            p -= strlen(thousands_sep);
+            memcpy(p, thousands_sep, strlen(thousands_sep));
+            run = 0;
+            if (group[1] != '\0') {
+                group++;
+            }
         }
+        *--p = '0' + units % 10;
+        units /= 10;
+        run++;
+    } while (units > 0);
+    return p;
+}
+
+// Render an amount in the 14-character column: parenthesized when negative or when
+// type is '-', and question marks from 10,000,000.00 up.
+void format_money(int64_t cents, char *buf, char type) {
+    char out[64];
+    char number[48];
+    int negative = cents < 0 || type == '-';
+    cents = cents < 0 ? -cents : cents;
+    if (cents >= 1000000000) {
+        strcpy(out, negative ? "(?,???,???.\?\?)" : " ?,???,???.?? ");
     } else {
-        if (amount >= 10000000) {
-            sprintf(buf, " ?,???,???.?? ");
-        } else {
-            sprintf(buf, "%'13.2f ", amount);
+        char *start = format_cents(cents, number + sizeof(number));
+        int length = number + sizeof(number) - start;
+        int width = negative ? 12 : 13;
+        int pad = max(0, width - length);
+        char *p = out;
+        if (negative) {
+            *p++ = '(';
         }
+        memset(p, ' ', pad);
+        memcpy(p + pad, start, length);
+        p += pad + length;
+        *p++ = negative ? ')' : ' ';
+        *p = '\0';
     }
+    memcpy(buf, out, 14);
     buf[14] = '\0';
-    setlocale(LC_NUMERIC, original);
 }
 
-void print_result(My402List *list) {
-    double balance = 0;
+void print_header(void) {
     fprintf(stdout, "+-----------------+--------------------------+----------------+----------------+\n");
     fprintf(stdout, "|       Date      | Description              |         Amount |        Balance |\n");
     fprintf(stdout, "+-----------------+--------------------------+----------------+----------------+\n");
-    for (My402ListElem *elem = My402ListFirst(list); elem != NULL; elem = My402ListNext(list, elem)) {
-        Transaction *transaction = (Transaction*) (elem->obj);
+}
+
+void print_footer(void) {
+    fprintf(stdout, "+-----------------+--------------------------+----------------+----------------+\n");
+}
+
+// Add the transaction to the balance and print its row.
+void print_row(Transaction *transaction, int64_t *balance) {
+    *balance += signed_cents(transaction->type, transaction->cents);
+    // The row is assembled in one buffer: "| date | description | amount | balance |".
+    char row[128];
+    char time_buf[26];
+    formart_time(transaction->time, time_buf);
+    memcpy(row, "| ", 2);
+    memcpy(row + 2, time_buf, 15);
+    memcpy(row + 17, " | ", 3);
+    memcpy(row + 20, transaction->description, 24);
+    memcpy(row + 44, " | ", 3);
+    format_money(transaction->cents, row + 47, transaction->type);
+    memcpy(row + 61, " | ", 3);
+    format_money(*balance, row + 64, '+');
+    memcpy(row + 78, " |\n", 3);
+    fwrite(row, 1, 81, stdout);
+}
+
+void print_result(TransactionList *list, int64_t balance) {
+    print_header();
+    for (My402ListElem *elem = TransactionListFirst(list); elem != NULL; elem = TransactionListNext(list, elem)) {
+        print_row(TransactionListObj(elem), &balance);
+    }
+    print_footer();
+}
+
+void emit_row(Record *record, void *arg) {
+    Transaction transaction;
+    transaction.type = record->type;
+    transaction.time = record->time;
+    transaction.cents = record->cents;
+    memcpy(transaction.description, record->description, 24);
+    transaction.description[24] = '\0';
+    transaction.count = record->count;
+    if (before_range(transaction.time)) {
+        *(int64_t*) arg += signed_cents(transaction.type, transaction.cents);
+    } else if (!after_range(transaction.time)) {
+        print_row(&transaction, (int64_t*) arg);
+    }
+}
+
+// Streaming mode: print straight from the final merge of the runs.
+void print_runs(void) {
+    int64_t balance = 0;
+    print_header();
+    merge_runs(0, num_runs, emit_row, &balance);
+    print_footer();
+}
+
+// FNV-1a over INDEX_CHECKPOINTS blocks of the first size bytes of data, evenly spaced
+// from the first block to the one ending at size. They overlap if size is small.
+uint64_t hash_checkpoints(const char *data, size_t size) {
+    size_t block = min(size, INDEX_BLOCK_BYTES);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < INDEX_CHECKPOINTS; i++) {
+        const char *start = data + (size - block) * i / (INDEX_CHECKPOINTS - 1);
+        for (const char *c = start; c < start + block; c++) {
+            hash = (hash ^ (unsigned char) *c) * 0x100000001b3ULL;
+        }
+    }
+    return hash;
+}
+
+int64_t mtime_ns(struct stat *st) {
+    return (int64_t) st->st_mtim.tv_sec * 1000000000 + st->st_mtim.tv_nsec;
+}
+
+// Whether the mapped tfile has the size, modification time and inode header recorded.
+int same_tfile(IndexHeader *header) {
+    return header->tfile_size == map_stat.st_size && header->tfile_mtime == mtime_ns(&map_stat) &&
+            header->tfile_inode == map_stat.st_ino;
+}
+
+// Map the index at path if it is intact and covers a prefix of the mapped tfile.
+// Otherwise leave index_records NULL so that everything is parsed and indexed afresh.
+void load_index(const char *path) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size < sizeof(IndexHeader)) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
+    }
+    index_map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (index_map == MAP_FAILED) {
+        index_map = NULL;
+        return;
+    }
+    index_size = st.st_size;
+    IndexHeader *header = (IndexHeader*) index_map;
+    if (memcmp(header->magic, INDEX_MAGIC, 8) != 0 ||
+            header->num_records < 0 || header->num_records > INT_MAX ||
+            index_size != sizeof(IndexHeader) + header->num_records * sizeof(IndexRecord) ||
+            header->indexed_bytes > map_size ||
+            (!same_tfile(header) && header->checkpoint_hash != hash_checkpoints(map, header->indexed_bytes))) {
+        return;
+    }
+    index_header = *header;
+    index_records = (IndexRecord*) (index_map + sizeof(IndexHeader));
+}
+
+// The first indexed record at or after time.
+int index_lower_bound(time_t time) {
+    int low = 0;
+    int high = index_header.num_records;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (index_records[mid].time < time) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Rebuild a transaction for printing from its record and the line it points at.
+void read_indexed(IndexRecord *record, Transaction *transaction) {
+    const char *start = map + record->offset;
+    const char *end = memchr(start, '\n', map + map_size - start);
+    end = end == NULL ? map + map_size : end + 1;
+    const char *nul = memchr(start, '\0', end - start);
+    if (nul != NULL) {
+        end = nul;
+    }
+    const char *pos = start;
+    const char *token = NULL;
+    for (int i = 0; i < 4; i++) {
+        token = next_token(&pos, end);
+    }
+    if (token == NULL || !copy_description(token, pos, transaction->description)) {
+        memset(transaction->description, ' ', 24);
+        transaction->description[24] = '\0';
+    }
+    transaction->type = record->type;
+    transaction->time = record->time;
+    transaction->cents = record->cents;
+    transaction->count = record->count;
+    transaction->offset = record->offset;
+}
+
+void to_index_record(Transaction *transaction, IndexRecord *record) {
+    memset(record, 0, sizeof(IndexRecord));
+    record->time = transaction->time;
+    record->cents = transaction->cents;
+    record->offset = transaction->offset;
+    record->count = transaction->count;
+    record->type = transaction->type;
+}
+
+int write_index_record(FILE *out, IndexRecord record, int64_t *balance) {
+    *balance += signed_cents(record.type, record.cents);
+    record.balance = *balance;
+    return fwrite(&record, sizeof(IndexRecord), 1, out) == 1;
+}
+
+// Bring the index at path up to date with the new rows in transactions. New rows that
+// all come after the indexed ones are appended to the index in place; otherwise the
+// merged index is written next to it and renamed over it. Returns FALSE on failure.
+int update_index(const char *path, int num_lines) {
+    // A last line without a newline may still grow, so it is left out of the index.
+    const char *newline = map + map_size;
+    while (newline > map && newline[-1] != '\n') {
+        newline--;
+    }
+    IndexHeader header;
+    memcpy(header.magic, INDEX_MAGIC, 8);
+    header.indexed_bytes = newline - map;
+    header.checkpoint_hash = hash_checkpoints(map, header.indexed_bytes);
+    header.tfile_size = map_stat.st_size;
+    header.tfile_mtime = mtime_ns(&map_stat);
+    header.tfile_inode = map_stat.st_ino;
+    header.num_records = index_records == NULL ? 0 : index_header.num_records;
+    header.num_lines = num_lines - (newline < map + map_size);
+    header.balance = index_records == NULL ? 0 : index_header.balance;
+    int num_old = header.num_records;
+    int num_new = 0;
+    for (int i = 0; i < num_transactions; i++) {
+        if (transactions[i].offset < header.indexed_bytes) {
+            header.balance += signed_cents(transactions[i].type, transactions[i].cents);
+            num_new++;
+        }
+    }
+    header.num_records += num_new;
+    // A tfile that was touched but not grown only needs the header rewritten, which the
+    // in-place append below does.
+    if (num_new == 0 && index_records != NULL && header.indexed_bytes == index_header.indexed_bytes && same_tfile(&index_header)) {
+        return TRUE;
+    }
+
+    IndexRecord record;
+    int64_t balance = 0;
+    int ok;
+    if (num_old > 0 && (num_transactions == 0 || transactions[sorted[0].index].time > index_records[num_old - 1].time)) {
+        FILE *out = fopen(path, "r+");
+        ok = out != NULL && fseek(out, 0, SEEK_END) == 0;
+        balance = index_header.balance;
+        for (int j = 0; j < num_transactions && ok; j++) {
+            Transaction *transaction = &transactions[sorted[j].index];
+            if (transaction->offset < header.indexed_bytes) {
+                to_index_record(transaction, &record);
+                ok = write_index_record(out, record, &balance);
+            }
+        }
+        // The header goes last, so a half-written index fails its size check.
+        ok = ok && fflush(out) == 0 && fseek(out, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(IndexHeader), 1, out) == 1;
+        if (out != NULL) {
+            ok = fclose(out) == 0 && ok;
+        }
+        return ok;
+    }
+    char *tmp_path = malloc(strlen(path) + 5);
+    sprintf(tmp_path, "%s.tmp", path);
+    FILE *out = fopen(tmp_path, "w");
+    ok = out != NULL && fwrite(&header, sizeof(IndexHeader), 1, out) == 1;
+    int i = 0;
+    int j = 0;
+    while ((i < num_old || j < num_transactions) && ok) {
+        if (j == num_transactions || (i < num_old && index_records[i].time < transactions[sorted[j].index].time)) {
+            ok = write_index_record(out, index_records[i++], &balance);
+        } else {
+            Transaction *transaction = &transactions[sorted[j++].index];
+            if (transaction->offset < header.indexed_bytes) {
+                to_index_record(transaction, &record);
+                ok = write_index_record(out, record, &balance);
+            }
+        }
+    }
+    if (out != NULL) {
+        ok = fclose(out) == 0 && ok;
+    }
+    ok = ok && rename(tmp_path, path) == 0;
+    if (!ok) {
+        remove(tmp_path);
+    }
+    free(tmp_path);
+    return ok;
+}
+
+// Print the indexed rows in range merged with the new ones in transactions. The opening
+// balance comes from the record just before the range, so the work done is in
+// proportion to the rows printed and the new rows, not to the whole ledger.
+void print_indexed(const char *path) {
+    int num_old = index_records == NULL ? 0 : index_header.num_records;
+    int i = ranged ? index_lower_bound(range_start) : 0;
+    int end = ranged ? index_lower_bound(range_end) : num_old;
+    // An index trusted on the tfile's size and times alone is still checked before its
+    // records are followed back into the tfile.
+    for (int k = i; k < end; k++) {
+        if (index_records[k].offset < 0 || index_records[k].offset >= index_header.indexed_bytes) {
+            fprintf(stderr, "Error: Index file %s is corrupt; remove it and run again\n", path);
+            free_all(NULL);
+            exit(1);
+        }
+    }
+    int64_t balance = i > 0 ? index_records[i - 1].balance : 0;
+    int j = 0;
+    while (j < num_transactions && before_range(transactions[sorted[j].index].time)) {
+        Transaction *transaction = &transactions[sorted[j++].index];
+        balance += signed_cents(transaction->type, transaction->cents);
+    }
+    print_header();
+    while (i < end || (j < num_transactions && !after_range(transactions[sorted[j].index].time))) {
+        Transaction transaction;
+        if (j == num_transactions || after_range(transactions[sorted[j].index].time) ||
+                (i < end && index_records[i].time < transactions[sorted[j].index].time)) {
+            read_indexed(&index_records[i++], &transaction);
+        } else {
+            transaction = transactions[sorted[j++].index];
+        }
+        print_row(&transaction, &balance);
+    }
+    print_footer();
+}
+
+// "warmup1 compile" writes the validated, sorted ledger as a binary file of columns, so
+// that "warmup1 sort --bin" can print it straight from a mapping without parsing:
+//
+//   CompiledHeader
+//   time_t    times[num_rows]
+//   int64_t   cents[num_rows]
+//   uint64_t  types[(num_rows + 63) / 64]     bit i set if row i is a deposit
+//   char      descriptions[num_rows][24]      padded with spaces, as printed
+//
+// in time order. Every column starts 8-byte aligned.
+typedef struct {
+    char magic[8];
+    int64_t num_rows;
+    int32_t time_size;      // sizeof(time_t) on the machine that wrote it
+    int32_t unused;
+    int64_t balance;        // after the last row, in cents
+} CompiledHeader;
+
+#define COMPILED_MAGIC "W1COLS01"
+
+typedef struct {
+    time_t *times;
+    int64_t *cents;
+    uint64_t *types;
+    char *descriptions;
+    size_t size;            // of the whole file
+} CompiledColumns;
+
+void compiled_layout(char *base, int64_t num_rows, CompiledColumns *columns) {
+    char *p = base + sizeof(CompiledHeader);
+    columns->times = (time_t*) p;
+    p += num_rows * sizeof(time_t);
+    columns->cents = (int64_t*) p;
+    p += num_rows * sizeof(int64_t);
+    columns->types = (uint64_t*) p;
+    p += (num_rows + 63) / 64 * sizeof(uint64_t);
+    columns->descriptions = p;
+    p += num_rows * 24;
+    columns->size = p - base;
+}
+
+// Write the transactions, already sorted by check_duplicates(), to path.
+int write_compiled(const char *path) {
+    CompiledHeader header;
+    memset(&header, 0, sizeof(CompiledHeader));
+    memcpy(header.magic, COMPILED_MAGIC, 8);
+    header.num_rows = num_transactions;
+    header.time_size = sizeof(time_t);
+    int num_words = (num_transactions + 63) / 64;
+    uint64_t *types = calloc(max(num_words, 1), sizeof(uint64_t));
+    for (int i = 0; i < num_transactions && types != NULL; i++) {
+        Transaction *transaction = &transactions[sorted[i].index];
         if (transaction->type == '+') {
-            balance += transaction->amount;
+            types[i / 64] |= (uint64_t) 1 << (i % 64);
+            header.balance += transaction->cents;
         } else {
-            balance -= transaction->amount;
-        }
-        char time_buf[26];
-        char amount_buf[15];
-        char balance_buf[15];
-        formart_time(transaction->time, time_buf);
-        format_money(transaction->amount, amount_buf, transaction->type);
-        format_money(balance, balance_buf, '+');
-        fprintf(stdout, "| %s ", time_buf);
-        fprintf(stdout, "| %s ", transaction->description);
-        fprintf(stdout, "| %s ", amount_buf);
-        fprintf(stdout, "| %s |\n", balance_buf);
+            header.balance -= transaction->cents;
+        }
     }
-    fprintf(stdout, "+-----------------+--------------------------+----------------+----------------+\n");
+    FILE *out = fopen(path, "w");
+    int ok = types != NULL && out != NULL && fwrite(&header, sizeof(CompiledHeader), 1, out) == 1;
+    for (int i = 0; i < num_transactions && ok; i++) {
+        ok = fwrite(&transactions[sorted[i].index].time, sizeof(time_t), 1, out) == 1;
+    }
+    for (int i = 0; i < num_transactions && ok; i++) {
+        ok = fwrite(&transactions[sorted[i].index].cents, sizeof(int64_t), 1, out) == 1;
+    }
+    ok = ok && fwrite(types, sizeof(uint64_t), num_words, out) == num_words;
+    for (int i = 0; i < num_transactions && ok; i++) {
+        ok = fwrite(transactions[sorted[i].index].description, 24, 1, out) == 1;
+    }
+    if (out != NULL) {
+        ok = fclose(out) == 0 && ok;
+    }
+    free(types);
+    return ok;
+}
+
+// Map fp if it is a regular file, so that it can be parsed in place.
+void map_input(void) {
+    if (fstat(fileno(fp), &map_stat) == 0 && S_ISREG(map_stat.st_mode) && map_stat.st_size > 0) {
+        map = mmap(NULL, map_stat.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+        if (map == MAP_FAILED) {
+            map = NULL;
+        } else {
+            map_size = map_stat.st_size;
+            madvise(map, map_size, MADV_SEQUENTIAL);
+        }
+    }
+}
+
+// Parse fp into transactions, from the line at from on if it is mapped, numbering lines
+// after the first base_lines. Exits on the first bad line. Returns the number of lines.
+int read_input(const char *from, int base_lines) {
+    Chunk chunks[MAX_THREADS];
+    int num_chunks = 1;
+    if (map != NULL) {
+        num_chunks = parse_mapped(chunks, num_threads(map + map_size - from), from);
+    } else {
+        memset(&chunks[0], 0, sizeof(Chunk));
+        ssize_t rv;
+        while (chunks[0].error == PARSE_OK && (rv = getline(&line, &line_size, fp)) != -1) {
+            chunks[0].error = add_line(&chunks[0], line, line + rv);
+        }
+    }
+    int error;
+    int count = merge_chunks(chunks, num_chunks, &error);
+    for (int i = 0; i < num_transactions && base_lines > 0; i++) {
+        transactions[i].count += base_lines;
+    }
+    count += base_lines;
+    if (error != PARSE_OK) {
+        fail(error, count);
+    }
+    if (count < 1) {
+        error_prefix();
+        fprintf(stderr, "Error: A valid file must contain at least one transaction\n");
+        free_all(NULL);
+        exit(1);
+    }
+    return count;
+}
+
+// Read each tfile into a shard of its own. One already in time order is kept as it is,
+// anything else is sorted; either way its duplicates are reported like a single file's.
+void read_shards(char **names, int n) {
+    shards = calloc(n, sizeof(Shard));
+    if (shards == NULL) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    for (int i = 0; i < n; i++) {
+        shard_name = names[i];
+        fp = fopen(shard_name, "r");
+        if (fp == NULL) {
+            fprintf(stderr, "Error: Cannot open file %s\n", shard_name);
+            free_all(NULL);
+            exit(1);
+        }
+        map_input();
+        read_input(map, 0);
+        int in_order = TRUE;
+        for (int j = 1; j < num_transactions && in_order; j++) {
+            in_order = transactions[j - 1].time < transactions[j].time;
+        }
+        if (!in_order) {
+            check_duplicates();
+        }
+        Shard *shard = &shards[num_shards++];
+        shard->name = shard_name;
+        shard->rows = transactions;
+        shard->num_rows = num_transactions;
+        shard->order = sorted;
+        transactions = NULL;
+        num_transactions = 0;
+        sorted = NULL;
+        if (map != NULL) {
+            munmap(map, map_size);
+            map = NULL;
+            map_size = 0;
+        }
+        fclose(fp);
+        fp = NULL;
+    }
+    shard_name = NULL;
+}
+
+Transaction *shard_row(Shard *shard) {
+    return &shard->rows[shard->order == NULL ? shard->next : shard->order[shard->next].index];
+}
+
+// Shards ordered by their next row, ties going to the earlier tfile.
+int shard_less(int a, int b) {
+    time_t time_a = shard_row(&shards[a])->time;
+    time_t time_b = shard_row(&shards[b])->time;
+    return time_a < time_b || (time_a == time_b && a < b);
+}
+
+void sift_shards(int *heap, int size, int parent) {
+    for (int child; (child = 2 * parent + 1) < size; parent = child) {
+        if (child + 1 < size && shard_less(heap[child + 1], heap[child])) {
+            child++;
+        }
+        if (!shard_less(heap[child], heap[parent])) {
+            break;
+        }
+        int tmp = heap[parent];
+        heap[parent] = heap[child];
+        heap[child] = tmp;
+    }
+}
+
+// Merge the shards in time order, calling emit on each row with the shard it is from.
+// Stops early and returns FALSE if emit does.
+int merge_shards(int (*emit)(Transaction*, Shard*, void*), void *arg) {
+    int *heap = malloc(num_shards * sizeof(int));
+    if (heap == NULL) {
+        out_of_memory();
+    }
+    int size = 0;
+    for (int i = 0; i < num_shards; i++) {
+        shards[i].next = 0;
+        if (shards[i].num_rows > 0) {
+            heap[size++] = i;
+        }
+    }
+    for (int i = size / 2 - 1; i >= 0; i--) {
+        sift_shards(heap, size, i);
+    }
+    int ok = TRUE;
+    while (size > 0 && ok) {
+        Shard *shard = &shards[heap[0]];
+        ok = emit(shard_row(shard), shard, arg);
+        if (++shard->next == shard->num_rows) {
+            heap[0] = heap[--size];
+        }
+        sift_shards(heap, size, 0);
+    }
+    free(heap);
+    return ok;
+}
+
+typedef struct {
+    Transaction *last;
+    Shard *last_shard;
+} ShardScan;
+
+int emit_shard_duplicate(Transaction *transaction, Shard *shard, void *arg) {
+    ShardScan *scan = (ShardScan*) arg;
+    if (scan->last != NULL && scan->last->time == transaction->time) {
+        fprintf(stderr, "Error: Duplicate timestamp on line %d of %s and line %d of %s\n", scan->last->count, scan->last_shard->name, transaction->count, shard->name);
+        return FALSE;
+    }
+    scan->last = transaction;
+    scan->last_shard = shard;
+    return TRUE;
+}
+
+int emit_shard_row(Transaction *transaction, Shard *shard, void *arg) {
+    print_row(transaction, (int64_t*) arg);
+    return TRUE;
+}
+
+// "warmup1 sort tfile tfile ...": check the merge for timestamps shared between tfiles,
+// the earliest first, then merge again to print.
+void print_shards(void) {
+    ShardScan scan;
+    memset(&scan, 0, sizeof(ShardScan));
+    if (!merge_shards(emit_shard_duplicate, &scan)) {
+        free_all(NULL);
+        exit(1);
+    }
+    init_money_format();
+    int64_t balance = 0;
+    print_header();
+    merge_shards(emit_shard_row, &balance);
+    print_footer();
+}
+
+// Print the compiled ledger open on fp.
+void print_compiled(const char *name) {
+    struct stat st;
+    if (fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= sizeof(CompiledHeader)) {
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+        if (map == MAP_FAILED) {
+            map = NULL;
+        } else {
+            map_size = st.st_size;
+            madvise(map, map_size, MADV_SEQUENTIAL);
+        }
+    }
+    CompiledHeader *header = (CompiledHeader*) map;
+    CompiledColumns columns;
+    if (map == NULL || memcmp(header->magic, COMPILED_MAGIC, 8) != 0 || header->time_size != sizeof(time_t) ||
+            header->num_rows < 1 || header->num_rows > (int64_t) (map_size / 24)) {
+        fprintf(stderr, "Error: %s is not a compiled ledger\n", name);
+        free_all(NULL);
+        exit(1);
+    }
+    compiled_layout(map, header->num_rows, &columns);
+    if (columns.size != map_size) {
+        fprintf(stderr, "Error: %s is not a compiled ledger\n", name);
+        free_all(NULL);
+        exit(1);
+    }
+    init_money_format();
+    int64_t balance = 0;
+    print_header();
+    for (int64_t i = 0; i < header->num_rows; i++) {
+        Transaction transaction;
+        transaction.time = columns.times[i];
+        transaction.cents = columns.cents[i];
+        transaction.type = (columns.types[i / 64] >> (i % 64)) & 1 ? '+' : '-';
+        memcpy(transaction.description, columns.descriptions + i * 24, 24);
+        print_row(&transaction, &balance);
+    }
+    print_footer();
 }
 
 int main(int argc, char *argv[]) {
-    if (argc == 2 && (strcmp("sort", argv[1]) == 0)) {
+    int malformed = FALSE;
+    int binary = FALSE;
+    char *inFile = NULL;
+    char *out_file = NULL;
+    if (argc >= 4 && (strcmp("sort", argv[1]) == 0) && (strcmp("--bin", argv[2]) != 0)) {
+        // Several tfiles; WARMUP1_MEMORY and WARMUP1_INDEX do not apply.
+        read_shards(argv + 2, argc - 2);
+        print_shards();
+        free_all(NULL);
+        return EXIT_SUCCESS;
+    } else if (argc >= 2 && (strcmp("sort", argv[1]) == 0)) {
+        binary = argc >= 3 && (strcmp("--bin", argv[2]) == 0);
+        malformed = argc > 3 + binary;
+        inFile = argc == 3 + binary ? argv[argc - 1] : NULL;
+    } else if ((argc == 4 || argc == 5) && (strcmp("range", argv[1]) == 0)) {
+        if (!parse_time(argv[2], &range_start) || !parse_time(argv[3], &range_end) || range_start > range_end) {
+            fprintf(stderr, "Error: Invalid time range %s %s\n", argv[2], argv[3]);
+            exit(1);
+        }
+        ranged = TRUE;
+        inFile = argc == 5 ? argv[4] : NULL;
+    } else if (argc == 4 && (strcmp("compile", argv[1]) == 0)) {
+        inFile = argv[2];
+        out_file = argv[3];
+    } else {
+        malformed = TRUE;
+    }
+    if (malformed) {
+        fprintf(stderr, "Error: Malformed command\n");
+        usage();
+    }
+    if (inFile == NULL) {
         fp = stdin;
-    } else if (argc == 3 && (strcmp("sort", argv[1]) == 0)) {
-        char *inFile = argv[2];
+    } else {
         fp = fopen(inFile, "r");
         if (fp == NULL) {
             fprintf(stderr, "Error: Cannot open file %s\n", inFile);
             exit(1);
         }
-    } else {
-        fprintf(stderr, "Error: Malformed command\n");
-        usage();
     }
-    char *line = NULL;
-    size_t length = 0;
-    int rv = 0;
-    My402List list;
-    if (!My402ListInit(&list)) {
-        fprintf(stderr, "Error: Failed to initialize My402List\n");
-        exit(1);
+    if (binary) {
+        print_compiled(inFile == NULL ? "stdin" : inFile);
+        free_all(NULL);
+        return EXIT_SUCCESS;
     }
-    int count = 0;
-    while ((rv = getline(&line, &length, fp)) != -1) {
-        count++;
-        if (rv > 1024) {
-            fprintf(stderr, "Error: The line %d is longer than 1024 characters\n", count);
-            free_list(&list, NULL, line);
+    // Compiling sorts in memory and leaves any index alone.
+    char *budget = out_file == NULL ? getenv("WARMUP1_MEMORY") : NULL;
+    if (budget != NULL) {
+        memory_budget = parse_size(budget);
+        if (memory_budget == 0) {
+            fprintf(stderr, "Error: Bad WARMUP1_MEMORY value %s\n", budget);
+            fclose(fp);
             exit(1);
         }
-        Transaction *transaction = parse_line(line, &list, count);
-        line = NULL;
-        length = 0;
-        insertion_sort(&list, transaction);
+        run_rows = min(max(memory_budget / ROW_BYTES, 1), INT_MAX);
     }
-    if (count < 1) {
-        fprintf(stderr, "Error: A valid file must contain at least one transaction\n");
-        free_list(&list, NULL, line);
+    char *index_path = out_file == NULL ? getenv("WARMUP1_INDEX") : NULL;
+    if (index_path != NULL && (inFile == NULL || *index_path == '\0')) {
+        index_path = NULL;
+    }
+    if (index_path != NULL) {
+        // The index needs the tfile mapped, and keeps only new rows in memory anyway.
+        memory_budget = 0;
+        run_rows = INT_MAX;
+    }
+    // A mapping would count against the budget in streaming mode, so lines it is then.
+    if (memory_budget == 0) {
+        map_input();
+    }
+    if (map == NULL) {
+        index_path = NULL;
+    }
+    const char *from = map;
+    int base_lines = 0;
+    if (index_path != NULL) {
+        load_index(index_path);
+        if (index_records != NULL) {
+            from = map + index_header.indexed_bytes;
+            base_lines = index_header.num_lines;
+        }
+    }
+    int count = read_input(from, base_lines);
+    check_duplicates();
+    if (out_file != NULL) {
+        int ok = write_compiled(out_file);
+        if (!ok) {
+            fprintf(stderr, "Error: Cannot write file %s\n", out_file);
+        }
+        free_all(NULL);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    init_money_format();
+    if (num_runs > 0) {
+        print_runs();
+        free_all(NULL);
+        return EXIT_SUCCESS;
+    }
+    if (index_path != NULL) {
+        // The output does not depend on the index being written, so print it either way.
+        int ok = update_index(index_path, count);
+        print_indexed(index_path);
+        if (!ok) {
+            fprintf(stderr, "Error: Cannot write index file %s\n", index_path);
+        }
+        free_all(NULL);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    TransactionList list;
+    if (!My402ListPoolInit(&pool, 1024) || !TransactionListInit(&list, &pool)) {
+        fprintf(stderr, "Error: Failed to initialize My402List\n");
+        free_all(NULL);
         exit(1);
     }
-    print_result(&list);
-    free_list(&list, NULL, line);
+    int first = ranged ? sorted_lower_bound(range_start) : 0;
+    int end = ranged ? sorted_lower_bound(range_end) : num_transactions;
+    for (int i = first; i < end; i++) {
+        TransactionListAppend(&list, &transactions[sorted[i].index]);
+    }
+    print_result(&list, ranged && first > 0 ? opening_balance(first) : 0);
+    free_all(&list);
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,1204 @@
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+#include "cs402.h"
+#include "my402list.h"
+#include "my402poollist.h"
+#include "my402indexedlist.h"
+#ifdef LISTBENCH_SIBLINGS
+#include "my402ulist.h"
+#include "my402clist.h"
+#include "my402skiplist.h"
+#endif
+
+// Microbenchmark for My402List and its sibling containers. Each line of output is
+// one measurement as space-separated key=value pairs, e.g.
+//
+//   op=Append mode=pooled pattern=seq n=1000000 ns_per_op=7.9 allocs_per_op=0.001
+//
+// mode is how the list is set up (plain malloc, pooled, or malloc with the Find
+// index; typed is the malloc list read through MY402LIST_TYPED wrappers) or which
+// sibling container is measured (ulist, clist, skiplist), and pattern is where in the list
+// each operation lands (seq: at the ends or in list order; rand: at a random
+// element; chunks: a chunk-by-chunk scan). Allocations are counted by wrapping
+// malloc/calloc at link time, see the listbench rule in the Makefile.
+// "op=Memory" lines give the bytes held per element instead of a time.
+//
+// Before measuring, the indexed list and every sibling container are checked against
+// a plain My402List driven through the same random operations (pattern=rand), and
+// the My402List calls no benchmark exercises are checked against a plain array
+// (pattern=moves, sort, destroy). Each check prints one "op=Check ... check=ok" line; a mismatch is
+// reported on stderr and exits with 1.
+//
+// This file is the same in both warmup directories. The sibling containers are only
+// in warmup1, whose Makefile builds it with -DLISTBENCH_SIBLINGS.
+
+extern void *__real_malloc(size_t);
+extern void *__real_calloc(size_t, size_t);
+
+long num_allocs = 0;
+
+void *__wrap_malloc(size_t size) {
+    num_allocs++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    num_allocs++;
+    return __real_calloc(count, size);
+}
+
+typedef enum { MODE_MALLOC, MODE_POOLED, MODE_INDEXED, MODE_ULIST, MODE_CLIST, MODE_SKIPLIST, MODE_TYPED } Mode;
+
+const char *mode_names[] = { "malloc", "pooled", "indexed", "ulist", "clist", "skiplist", "typed" };
+
+// The list under test is read through list, which points into plain, pooled or
+// indexed depending on mode. Changes go through the helpers below, which pick the
+// functions for the mode.
+MY402LIST_TYPED(ObjList, char)
+
+Mode mode;
+ObjList plain;
+My402ListPool pool;
+My402PoolList pooled;
+My402IndexedList indexed;
+My402List *list;
+
+char *objs;                 // object i is objs + i, so every object is a distinct pointer
+My402ListElem **elems;      // elements of the list under test, in a chosen order
+long *order;                // random permutation of 0 .. n-1
+unsigned int seed = 1;
+
+#define CHECK_STEPS 20000
+#define CHECK_MAX_MEMBERS 300
+#define CHECK_OBJS 1000
+#define CHECK_SORT_ROUNDS 2000
+#define CHECK_DESTROY_ROUNDS 1000
+
+char check_objs[CHECK_OBJS];    // objects for the checks; repeats are likely
+#ifdef LISTBENCH_SIBLINGS
+int check_keys[CHECK_OBJS];     // objects for the skip list check, with repeated keys
+#endif
+int sort_keys[CHECK_MAX_MEMBERS];           // objects for the sort check, likewise
+void *dup_pairs[CHECK_MAX_MEMBERS][2];      // dup callbacks from the last sort
+int num_dup_pairs;
+int destroyed[CHECK_OBJS];                  // destructor calls per check object
+
+void usage(void) {
+    fprintf(stderr, "usage: listbench [-s seed] [-n size[,size...]]\n");
+    exit(1);
+}
+
+double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+void report(const char *op, Mode mode, const char *pattern, long n, double elapsed, long allocs, long ops) {
+    fprintf(stdout, "op=%s mode=%s pattern=%s n=%ld ns_per_op=%.1f allocs_per_op=%.3f\n", op, mode_names[mode], pattern, n, elapsed / ops, (double) allocs / ops);
+    fflush(stdout);
+}
+
+void report_memory(Mode mode, const char *pattern, long n, size_t bytes) {
+    fprintf(stdout, "op=Memory mode=%s pattern=%s n=%ld bytes_per_elem=%.1f\n", mode_names[mode], pattern, n, (double) bytes / n);
+    fflush(stdout);
+}
+
+void shuffle(long *a, long n) {
+    for (long i = n - 1; i > 0; i--) {
+        long j = rand() % (i + 1);
+        long tmp = a[i];
+        a[i] = a[j];
+        a[j] = tmp;
+    }
+}
+
+void init_list(void) {
+    My402ListPoolInit(&pool, 1024);
+    if (mode == MODE_MALLOC) {
+        ObjListInit(&plain);
+        list = &(plain.list);
+    } else if (mode == MODE_POOLED) {
+        My402PoolListInit(&pooled, &pool);
+        list = &(pooled.list);
+    } else {
+        My402IndexedListInit(&indexed);
+        list = &(indexed.list);
+    }
+}
+
+int append(void *obj) {
+    if (mode == MODE_POOLED) {
+        return My402PoolListAppend(&pooled, obj);
+    } else if (mode == MODE_INDEXED) {
+        return My402IndexedListAppend(&indexed, obj);
+    }
+    return My402ListAppend(&(plain.list), obj);
+}
+
+int prepend(void *obj) {
+    if (mode == MODE_POOLED) {
+        return My402PoolListPrepend(&pooled, obj);
+    } else if (mode == MODE_INDEXED) {
+        return My402IndexedListPrepend(&indexed, obj);
+    }
+    return My402ListPrepend(&(plain.list), obj);
+}
+
+int insert_after(void *obj, My402ListElem *elem) {
+    if (mode == MODE_POOLED) {
+        return My402PoolListInsertAfter(&pooled, obj, elem);
+    } else if (mode == MODE_INDEXED) {
+        return My402IndexedListInsertAfter(&indexed, obj, elem);
+    }
+    return My402ListInsertAfter(&(plain.list), obj, elem);
+}
+
+int insert_before(void *obj, My402ListElem *elem) {
+    if (mode == MODE_POOLED) {
+        return My402PoolListInsertBefore(&pooled, obj, elem);
+    } else if (mode == MODE_INDEXED) {
+        return My402IndexedListInsertBefore(&indexed, obj, elem);
+    }
+    return My402ListInsertBefore(&(plain.list), obj, elem);
+}
+
+void unlink_elem(My402ListElem *elem) {
+    if (mode == MODE_POOLED) {
+        My402PoolListUnlink(&pooled, elem);
+    } else if (mode == MODE_INDEXED) {
+        My402IndexedListUnlink(&indexed, elem);
+    } else {
+        My402ListUnlink(&(plain.list), elem);
+    }
+}
+
+void unlink_all(void) {
+    if (mode == MODE_POOLED) {
+        My402PoolListUnlinkAll(&pooled);
+    } else if (mode == MODE_INDEXED) {
+        My402IndexedListUnlinkAll(&indexed);
+    } else {
+        My402ListUnlinkAll(&(plain.list));
+    }
+}
+
+My402ListElem *find(void *obj) {
+    return mode == MODE_INDEXED ? My402IndexedListFind(&indexed, obj) : My402ListFind(list, obj);
+}
+
+void free_list(void) {
+    if (mode == MODE_INDEXED) {
+        My402IndexedListDestroy(&indexed, NULL);
+    } else {
+        unlink_all();
+    }
+    My402ListPoolFree(&pool);
+}
+
+// Build a list of objects 0 .. n-1 in order and remember each element.
+void fill(long n) {
+    for (long i = 0; i < n; i++) {
+        append(objs + i);
+        elems[i] = My402ListLast(list);
+    }
+}
+
+int compare_order(void *a, void *b) {
+    long x = order[(char*) a - objs];
+    long y = order[(char*) b - objs];
+    return x < y ? -1 : x > y;
+}
+
+void check_failed(const char *what, long step) {
+    fprintf(stderr, "Error: %s check failed after step %ld\n", what, step);
+    exit(1);
+}
+
+void report_check(Mode mode, const char *pattern, long steps) {
+    fprintf(stdout, "op=Check mode=%s pattern=%s steps=%ld check=ok\n", mode_names[mode], pattern, steps);
+    fflush(stdout);
+}
+
+// The operation for the next check step: 0-3 insert, 4 find, 5-7 unlink. The list
+// grows until it holds about CHECK_MAX_MEMBERS objects and then hovers there.
+int check_op(int n) {
+    int op = rand() % 8;
+    if (n == 0 && op >= 4) {
+        return op % 4;
+    }
+    if (n >= CHECK_MAX_MEMBERS && op < 4) {
+        return 5;
+    }
+    return op;
+}
+
+My402ListElem *ref_at(My402List *ref, int k) {
+    My402ListElem *elem = My402ListFirst(ref);
+    for (int i = 0; i < k; i++) {
+        elem = My402ListNext(ref, elem);
+    }
+    return elem;
+}
+
+int ref_index(My402List *ref, My402ListElem *elem) {
+    int k = 0;
+    for (My402ListElem *cur = My402ListFirst(ref); cur != elem; cur = My402ListNext(ref, cur)) {
+        k++;
+    }
+    return k;
+}
+
+int compare_elem(const void *a, const void *b) {
+    My402ListElem *x = *(My402ListElem**) a;
+    My402ListElem *y = *(My402ListElem**) b;
+    return x < y ? -1 : x > y;
+}
+
+// Same objects in the same order, walked forwards and backwards, and an index with
+// one entry per element: every used slot names an element on the list holding the
+// slot's object, and Find for each object lands on such an element.
+int same_indexed(My402IndexedList *il, My402List *ref) {
+    My402List *list = &(il->list);
+    int n = My402ListLength(list);
+    if (n != My402ListLength(ref) || n > CHECK_MAX_MEMBERS || il->num_used != n || 2 * il->num_used > il->num_slots) {
+        return FALSE;
+    }
+    My402ListElem *members[CHECK_MAX_MEMBERS];
+    int k = 0;
+    My402ListElem *elem = My402ListFirst(ref);
+    for (My402ListElem *cur = My402ListFirst(list); cur != NULL || elem != NULL; cur = My402ListNext(list, cur), elem = My402ListNext(ref, elem)) {
+        if (cur == NULL || elem == NULL || cur->obj != elem->obj) {
+            return FALSE;
+        }
+        members[k++] = cur;
+    }
+    elem = My402ListLast(ref);
+    for (My402ListElem *cur = My402ListLast(list); cur != NULL || elem != NULL; cur = My402ListPrev(list, cur), elem = My402ListPrev(ref, elem)) {
+        if (cur == NULL || elem == NULL || cur->obj != elem->obj) {
+            return FALSE;
+        }
+    }
+    qsort(members, n, sizeof(My402ListElem*), compare_elem);
+    int used = 0;
+    for (int i = 0; i < il->num_slots; i++) {
+        My402ListIndexSlot *slot = &(il->slots[i]);
+        if (slot->elem == NULL) {
+            continue;
+        }
+        used++;
+        if (bsearch(&(slot->elem), members, n, sizeof(My402ListElem*), compare_elem) == NULL || slot->elem->obj != slot->obj) {
+            return FALSE;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        My402ListElem *found = My402IndexedListFind(il, members[i]->obj);
+        if (found == NULL || found->obj != members[i]->obj || bsearch(&found, members, n, sizeof(My402ListElem*), compare_elem) == NULL) {
+            return FALSE;
+        }
+    }
+    return used == n;
+}
+
+// My402IndexedList against a plain My402List, step by step on the k-th element of
+// both. Objects repeat, so Find may land on any element holding the object, and
+// unlinks keep exercising the index's backward-shift deletion.
+void check_indexed(void) {
+    My402IndexedList il;
+    My402List ref;
+    My402IndexedListInit(&il);
+    My402ListInit(&ref);
+    for (long step = 0; step < CHECK_STEPS; step++) {
+        int n = My402ListLength(&ref);
+        int op = check_op(n);
+        void *obj = check_objs + rand() % CHECK_OBJS;
+        int k = n == 0 ? 0 : rand() % n;
+        My402ListElem *elem = ref_at(&ref, k);
+        My402ListElem *at = ref_at(&(il.list), k);
+        int ok = TRUE;
+        if (op == 0) {
+            ok = My402IndexedListAppend(&il, obj) && My402ListAppend(&ref, obj);
+        } else if (op == 1) {
+            ok = My402IndexedListPrepend(&il, obj) && My402ListPrepend(&ref, obj);
+        } else if (op == 2) {
+            ok = My402IndexedListInsertAfter(&il, obj, at) && My402ListInsertAfter(&ref, obj, elem);
+        } else if (op == 3) {
+            ok = My402IndexedListInsertBefore(&il, obj, at) && My402ListInsertBefore(&ref, obj, elem);
+        } else if (op == 4) {
+            My402ListElem *found = My402IndexedListFind(&il, obj);
+            ok = (found != NULL) == (My402ListFind(&ref, obj) != NULL) && (found == NULL || found->obj == obj);
+        } else {
+            My402IndexedListUnlink(&il, at);
+            My402ListUnlink(&ref, elem);
+        }
+        if (rand() % 1000 == 0) {
+            My402IndexedListUnlinkAll(&il);
+            My402ListUnlinkAll(&ref);
+        } else if (rand() % 1000 == 0) {
+            My402IndexedListDestroy(&il, NULL);
+            My402ListUnlinkAll(&ref);
+            ok = ok && My402IndexedListInit(&il);
+        }
+        if (!ok || !same_indexed(&il, &ref)) {
+            check_failed("My402IndexedList", step);
+        }
+    }
+    My402IndexedListDestroy(&il, NULL);
+    My402ListUnlinkAll(&ref);
+    report_check(MODE_INDEXED, "rand", CHECK_STEPS);
+}
+
+// Whether list holds exactly objs[0 .. n-1], with num_members right and every link
+// and the anchor consistent in both directions.
+int same_objs(My402List *list, void **objs, int n) {
+    if (My402ListLength(list) != n || My402ListEmpty(list) != (n == 0)) {
+        return FALSE;
+    }
+    My402ListElem *anchor = &(list->anchor);
+    My402ListElem *elem = anchor->next;
+    for (int i = 0; i < n; i++, elem = elem->next) {
+        if (elem == anchor || elem->obj != objs[i] || elem->next->prev != elem || elem->prev->next != elem) {
+            return FALSE;
+        }
+    }
+    if (elem != anchor || anchor->next->prev != anchor || anchor->prev->next != anchor) {
+        return FALSE;
+    }
+    elem = My402ListLast(list);
+    for (int i = n - 1; i >= 0; i--, elem = My402ListPrev(list, elem)) {
+        if (elem == NULL || elem->obj != objs[i]) {
+            return FALSE;
+        }
+    }
+    return elem == NULL;
+}
+
+int compare_key(void *a, void *b) {
+    int x = *(int*) a;
+    int y = *(int*) b;
+    return x < y ? -1 : x > y;
+}
+
+// Move objs[from .. from+count-1] of one array model to position at of another.
+void move_objs(void **src, int *src_len, int from, int count, void **dst, int *dst_len, int at) {
+    memmove(dst + at + count, dst + at, (*dst_len - at) * sizeof(void*));
+    memcpy(dst + at, src + from, count * sizeof(void*));
+    *dst_len += count;
+    memmove(src + from, src + from + count, (*src_len - from - count) * sizeof(void*));
+    *src_len -= count;
+}
+
+// My402ListConcat, My402ListSplice and My402ListMoveRange between two plain lists,
+// against two arrays. The destination is the end of the list (elem NULL) or after a
+// random element, which may be the last one. MoveRange is given the run's length or
+// 0 at random, and the source is often empty after a Concat or Splice.
+void check_moves(void) {
+    My402List lists[2];
+    void *model[2][CHECK_MAX_MEMBERS];
+    int lens[2] = { 0, 0 };
+    My402ListInit(&lists[0]);
+    My402ListInit(&lists[1]);
+    for (long step = 0; step < CHECK_STEPS; step++) {
+        int d = rand() % 2;
+        int s = 1 - d;
+        My402List *dst = &lists[d];
+        My402List *src = &lists[s];
+        int at = lens[d];
+        My402ListElem *elem = NULL;
+        if (lens[d] > 0 && rand() % 3 != 0) {
+            at = 1 + rand() % lens[d];
+            elem = ref_at(dst, at - 1);
+        }
+        int op = rand() % 8;
+        if (op <= 2 && lens[0] + lens[1] >= CHECK_MAX_MEMBERS) {
+            op = 7;
+        }
+        int ok = TRUE;
+        if (op <= 2) {
+            void *obj = check_objs + rand() % CHECK_OBJS;
+            ok = My402ListAppend(dst, obj);
+            model[d][lens[d]++] = obj;
+        } else if (op == 3) {
+            ok = My402ListConcat(dst, src);
+            move_objs(model[s], &lens[s], 0, lens[s], model[d], &lens[d], lens[d]);
+        } else if (op == 4) {
+            ok = My402ListSplice(dst, elem, src);
+            move_objs(model[s], &lens[s], 0, lens[s], model[d], &lens[d], at);
+        } else if (op <= 6 && lens[s] > 0) {
+            int first = rand() % lens[s];
+            int last = first + rand() % (lens[s] - first);
+            int count = last - first + 1;
+            ok = My402ListMoveRange(dst, elem, src, ref_at(src, first), ref_at(src, last), rand() % 2 ? count : 0);
+            move_objs(model[s], &lens[s], first, count, model[d], &lens[d], at);
+        } else if (op == 7 && lens[d] > 0) {
+            int k = rand() % lens[d];
+            My402ListUnlink(dst, ref_at(dst, k));
+            memmove(model[d] + k, model[d] + k + 1, (lens[d] - k - 1) * sizeof(void*));
+            lens[d]--;
+        }
+        if (!ok || !same_objs(&lists[0], model[0], lens[0]) || !same_objs(&lists[1], model[1], lens[1])) {
+            check_failed("My402List bulk move", step);
+        }
+    }
+    My402ListUnlinkAll(&lists[0]);
+    My402ListUnlinkAll(&lists[1]);
+    report_check(MODE_MALLOC, "moves", CHECK_STEPS);
+}
+
+void record_dup(void *a, void *b) {
+    if (num_dup_pairs < CHECK_MAX_MEMBERS) {
+        dup_pairs[num_dup_pairs][0] = a;
+        dup_pairs[num_dup_pairs][1] = b;
+    }
+    num_dup_pairs++;
+}
+
+// Where sort_keys object obj ended up in the expected order, or -1 if it is not one
+// of the n sorted.
+int sorted_pos(void *obj, int *pos, int n) {
+    long i = (int*) obj - sort_keys;
+    return i >= 0 && i < n ? pos[i] : -1;
+}
+
+// My402ListSort on lists of distinct objects whose keys tie often, against a stable
+// insertion sort of the same input. The dup callback, when passed, must fire exactly
+// once for every adjacent pair of equal keys in the result, earlier object first.
+void check_sort(void) {
+    My402List list;
+    void *expected[CHECK_MAX_MEMBERS];
+    int pos[CHECK_MAX_MEMBERS];
+    My402ListInit(&list);
+    for (long round = 0; round < CHECK_SORT_ROUNDS; round++) {
+        int n = rand() % (CHECK_MAX_MEMBERS + 1);
+        int range = 1 + rand() % 20;
+        for (int i = 0; i < n; i++) {
+            sort_keys[i] = rand() % range;
+            expected[i] = sort_keys + i;
+        }
+        for (int i = n - 1; i > 0; i--) {
+            int j = rand() % (i + 1);
+            void *tmp = expected[i];
+            expected[i] = expected[j];
+            expected[j] = tmp;
+        }
+        for (int i = 0; i < n; i++) {
+            My402ListAppend(&list, expected[i]);
+        }
+        for (int i = 1; i < n; i++) {
+            void *obj = expected[i];
+            int j = i;
+            for (; j > 0 && compare_key(expected[j - 1], obj) > 0; j--) {
+                expected[j] = expected[j - 1];
+            }
+            expected[j] = obj;
+        }
+        int num_pairs = 0;
+        for (int i = 0; i < n; i++) {
+            pos[(int*) expected[i] - sort_keys] = i;
+            num_pairs += i > 0 && compare_key(expected[i - 1], expected[i]) == 0;
+        }
+        int with_dup = rand() % 4 != 0;
+        num_dup_pairs = 0;
+        My402ListSort(&list, compare_key, with_dup ? record_dup : NULL);
+        int ok = same_objs(&list, expected, n) && num_dup_pairs == (with_dup ? num_pairs : 0);
+        // Each reported pair is a distinct adjacent equal pair, in (earlier, later) order.
+        int seen[CHECK_MAX_MEMBERS];
+        memset(seen, 0, sizeof(seen));
+        for (int k = 0; k < num_dup_pairs && k < CHECK_MAX_MEMBERS && ok; k++) {
+            int a = sorted_pos(dup_pairs[k][0], pos, n);
+            int b = sorted_pos(dup_pairs[k][1], pos, n);
+            ok = a >= 0 && b == a + 1 && !seen[b] && compare_key(dup_pairs[k][0], dup_pairs[k][1]) == 0;
+            seen[max(b, 0)] = TRUE;
+        }
+        My402ListUnlinkAll(&list);
+        if (!ok) {
+            check_failed("My402ListSort", round);
+        }
+    }
+    report_check(MODE_MALLOC, "sort", CHECK_SORT_ROUNDS);
+}
+
+void count_destroy(void *obj) {
+    destroyed[(char*) obj - check_objs]++;
+}
+
+// Whether the destructor ran exactly once for each of objs[0 .. n-1], and for
+// nothing else, since destroyed was last cleared.
+int destroyed_once(void **objs, int n) {
+    int expected[CHECK_OBJS];
+    memset(expected, 0, sizeof(expected));
+    for (int i = 0; i < n; i++) {
+        expected[(char*) objs[i] - check_objs]++;
+    }
+    return memcmp(expected, destroyed, sizeof(destroyed)) == 0;
+}
+
+// My402ListDestroy and My402PoolListDestroy with a counting destructor. Pooled lists
+// are grown and thinned at random on a pool of small chunks, either alone or next to
+// a second list on the same pool. While the other list holds nodes, Destroy must hand
+// each node back to the pool's free list; once no other list does, it must free the
+// chunks wholesale. Either way the list is left empty and usable.
+void check_destroy(void) {
+    void *model[2][CHECK_MAX_MEMBERS];
+    int lens[2];
+    for (long round = 0; round < CHECK_DESTROY_ROUNDS; round++) {
+        My402List plain_list;
+        My402ListInit(&plain_list);
+        lens[0] = rand() % CHECK_MAX_MEMBERS;
+        for (int i = 0; i < lens[0]; i++) {
+            model[0][i] = check_objs + rand() % CHECK_OBJS;
+            My402ListAppend(&plain_list, model[0][i]);
+        }
+        memset(destroyed, 0, sizeof(destroyed));
+        My402ListDestroy(&plain_list, count_destroy);
+        if (!destroyed_once(model[0], lens[0]) || !same_objs(&plain_list, NULL, 0)) {
+            check_failed("My402ListDestroy", round);
+        }
+
+        My402ListPool pool;
+        My402PoolList lists[2];
+        My402ListPoolInit(&pool, 1 + rand() % 16);
+        My402PoolListInit(&lists[0], &pool);
+        My402PoolListInit(&lists[1], &pool);
+        int shared = rand() % 2;
+        lens[0] = 0;
+        lens[1] = 0;
+        for (int steps = rand() % (2 * CHECK_MAX_MEMBERS); steps > 0; steps--) {
+            int d = shared ? rand() % 2 : 0;
+            if (lens[d] > 0 && (rand() % 4 == 0 || lens[d] == CHECK_MAX_MEMBERS)) {
+                int k = rand() % lens[d];
+                My402PoolListUnlink(&lists[d], ref_at(&(lists[d].list), k));
+                memmove(model[d] + k, model[d] + k + 1, (lens[d] - k - 1) * sizeof(void*));
+                lens[d]--;
+            } else {
+                model[d][lens[d]] = check_objs + rand() % CHECK_OBJS;
+                My402PoolListAppend(&lists[d], model[d][lens[d]++]);
+            }
+        }
+        int num_chunks = pool.num_chunks;
+        int num_cached = pool.num_cached;
+        int ok = pool.num_live == lens[0] + lens[1] && pool.num_live + pool.num_cached == num_chunks * pool.nodes_per_chunk;
+        memset(destroyed, 0, sizeof(destroyed));
+        My402PoolListDestroy(&lists[0], count_destroy);
+        ok = ok && destroyed_once(model[0], lens[0]) && same_objs(&(lists[0].list), NULL, 0) && same_objs(&(lists[1].list), model[1], lens[1]);
+        if (lens[1] > 0) {
+            ok = ok && pool.num_chunks == num_chunks && pool.num_live == lens[1] && pool.num_cached == num_cached + lens[0];
+            memset(destroyed, 0, sizeof(destroyed));
+            My402PoolListDestroy(&lists[1], count_destroy);
+            ok = ok && destroyed_once(model[1], lens[1]) && same_objs(&(lists[1].list), NULL, 0);
+        }
+        ok = ok && pool.num_live == 0 && pool.num_cached == 0 && pool.num_chunks == 0 && pool.chunks == NULL && pool.free_elems == NULL;
+        // A destroyed list takes new nodes from the same pool.
+        ok = ok && My402PoolListAppend(&lists[0], check_objs) && pool.num_live == 1 && pool.num_chunks == 1;
+        My402PoolListDestroy(&lists[0], NULL);
+        ok = ok && pool.num_chunks == 0 && same_objs(&(lists[0].list), NULL, 0);
+        if (!ok) {
+            check_failed("My402PoolListDestroy", round);
+        }
+    }
+    report_check(MODE_MALLOC, "destroy", CHECK_DESTROY_ROUNDS);
+    report_check(MODE_POOLED, "destroy", CHECK_DESTROY_ROUNDS);
+}
+
+#ifdef LISTBENCH_SIBLINGS
+int ulist_index(My402UList *ulist, My402UListPos *pos) {
+    My402UListPos cur;
+    int k = 0;
+    for (My402UListFirst(ulist, &cur); cur.chunk != pos->chunk || cur.index != pos->index; My402UListNext(ulist, &cur)) {
+        k++;
+    }
+    return k;
+}
+
+void *ulist_obj(My402UListPos *pos) {
+    return pos->chunk == NULL ? NULL : pos->chunk->objs[pos->index];
+}
+
+// Same objects in the same order, walked forwards, backwards and chunk by chunk.
+int same_ulist(My402UList *ulist, My402List *ref) {
+    if (My402UListLength(ulist) != My402ListLength(ref)) {
+        return FALSE;
+    }
+    My402UListPos pos;
+    My402ListElem *elem = My402ListFirst(ref);
+    for (void *obj = My402UListFirst(ulist, &pos); obj != NULL || elem != NULL; obj = My402UListNext(ulist, &pos), elem = My402ListNext(ref, elem)) {
+        if (obj == NULL || elem == NULL || obj != elem->obj) {
+            return FALSE;
+        }
+    }
+    elem = My402ListLast(ref);
+    for (void *obj = My402UListLast(ulist, &pos); obj != NULL || elem != NULL; obj = My402UListPrev(ulist, &pos), elem = My402ListPrev(ref, elem)) {
+        if (obj == NULL || elem == NULL || obj != elem->obj) {
+            return FALSE;
+        }
+    }
+    elem = My402ListFirst(ref);
+    for (My402UListChunk *chunk = My402UListFirstChunk(ulist); chunk != NULL; chunk = My402UListNextChunk(ulist, chunk)) {
+        if (chunk->num_objs <= 0 || chunk->num_objs > MY402ULIST_CHUNK_OBJS) {
+            return FALSE;
+        }
+        for (int i = 0; i < chunk->num_objs; i++, elem = My402ListNext(ref, elem)) {
+            if (elem == NULL || chunk->objs[i] != elem->obj) {
+                return FALSE;
+            }
+        }
+    }
+    return elem == NULL;
+}
+
+// Every step works on the k-th element of both lists and checks the position the
+// UList call leaves behind, then compares the whole lists.
+void check_ulist(void) {
+    My402UList ulist;
+    My402List ref;
+    My402UListInit(&ulist);
+    My402ListInit(&ref);
+    for (long step = 0; step < CHECK_STEPS; step++) {
+        int n = My402ListLength(&ref);
+        int op = check_op(n);
+        void *obj = check_objs + rand() % CHECK_OBJS;
+        int k = n == 0 ? 0 : rand() % n;
+        My402ListElem *elem = ref_at(&ref, k);
+        My402UListPos pos;
+        My402UListFirst(&ulist, &pos);
+        for (int i = 0; i < k; i++) {
+            My402UListNext(&ulist, &pos);
+        }
+        int ok = TRUE;
+        if (op == 0) {
+            ok = My402UListAppend(&ulist, obj) && My402ListAppend(&ref, obj);
+        } else if (op == 1) {
+            ok = My402UListPrepend(&ulist, obj) && My402ListPrepend(&ref, obj);
+        } else if (op == 2 || op == 3) {
+            // With an empty list pos is past the end, which means append or prepend.
+            if (op == 2) {
+                ok = My402UListInsertAfter(&ulist, obj, &pos) && My402ListInsertAfter(&ref, obj, elem);
+            } else {
+                ok = My402UListInsertBefore(&ulist, obj, &pos) && My402ListInsertBefore(&ref, obj, elem);
+            }
+            ok = ok && (elem == NULL || ulist_obj(&pos) == elem->obj);
+        } else if (op == 4) {
+            My402ListElem *found = My402ListFind(&ref, obj);
+            if (My402UListFind(&ulist, obj, &pos) != (found != NULL)) {
+                ok = FALSE;
+            } else if (found != NULL) {
+                ok = ulist_obj(&pos) == obj && ulist_index(&ulist, &pos) == ref_index(&ref, found);
+            }
+        } else {
+            My402ListElem *next = My402ListNext(&ref, elem);
+            My402UListUnlink(&ulist, &pos);
+            My402ListUnlink(&ref, elem);
+            ok = ulist_obj(&pos) == (next == NULL ? NULL : next->obj);
+        }
+        if (rand() % 1000 == 0) {
+            My402UListUnlinkAll(&ulist);
+            My402ListUnlinkAll(&ref);
+        }
+        if (!ok || !same_ulist(&ulist, &ref)) {
+            check_failed("My402UList", step);
+        }
+    }
+    My402UListUnlinkAll(&ulist);
+    My402ListUnlinkAll(&ref);
+    report_check(MODE_ULIST, "rand", CHECK_STEPS);
+}
+
+My402CListIndex clist_at(My402CList *clist, int k) {
+    My402CListIndex index = My402CListFirst(clist);
+    for (int i = 0; i < k; i++) {
+        index = My402CListNext(clist, index);
+    }
+    return index;
+}
+
+int clist_index(My402CList *clist, My402CListIndex index) {
+    int k = 0;
+    for (My402CListIndex cur = My402CListFirst(clist); cur != index; cur = My402CListNext(clist, cur)) {
+        k++;
+    }
+    return k;
+}
+
+// Same objects in the same order, walked forwards and backwards.
+int same_clist(My402CList *clist, My402List *ref) {
+    if (My402CListLength(clist) != My402ListLength(ref) || My402CListEmpty(clist) != My402ListEmpty(ref)) {
+        return FALSE;
+    }
+    My402ListElem *elem = My402ListFirst(ref);
+    for (My402CListIndex index = My402CListFirst(clist); index != 0 || elem != NULL; index = My402CListNext(clist, index), elem = My402ListNext(ref, elem)) {
+        if (index == 0 || elem == NULL || My402CListObj(clist, index) != elem->obj) {
+            return FALSE;
+        }
+    }
+    elem = My402ListLast(ref);
+    for (My402CListIndex index = My402CListLast(clist); index != 0 || elem != NULL; index = My402CListPrev(clist, index), elem = My402ListPrev(ref, elem)) {
+        if (index == 0 || elem == NULL || My402CListObj(clist, index) != elem->obj) {
+            return FALSE;
+        }
+    }
+    return My402CListMemory(clist) >= (size_t) (My402CListLength(clist) + 1) * sizeof(My402CListNode);
+}
+
+// Like check_ulist(). The index of the k-th element is taken before each step and
+// must still name the same object afterwards (unless it was unlinked), since
+// indices stay valid while the node array grows. The list starts small so that the
+// array grows, and is now and then resized with My402CListReserve().
+void check_clist(void) {
+    My402CList clist;
+    My402List ref;
+    My402CListInit(&clist);
+    My402ListInit(&ref);
+    for (long step = 0; step < CHECK_STEPS; step++) {
+        int n = My402ListLength(&ref);
+        int op = check_op(n);
+        void *obj = check_objs + rand() % CHECK_OBJS;
+        int k = n == 0 ? 0 : rand() % n;
+        My402ListElem *elem = ref_at(&ref, k);
+        My402CListIndex index = clist_at(&clist, k);
+        int ok = TRUE;
+        if (op == 0) {
+            ok = My402CListAppend(&clist, obj) && My402ListAppend(&ref, obj);
+        } else if (op == 1) {
+            ok = My402CListPrepend(&clist, obj) && My402ListPrepend(&ref, obj);
+        } else if (op == 2) {
+            // Index 0 is the anchor, which means the end of the list, as NULL does.
+            ok = My402CListInsertAfter(&clist, obj, index) && My402ListInsertAfter(&ref, obj, elem);
+        } else if (op == 3) {
+            ok = My402CListInsertBefore(&clist, obj, index) && My402ListInsertBefore(&ref, obj, elem);
+        } else if (op == 4) {
+            My402ListElem *found = My402ListFind(&ref, obj);
+            My402CListIndex found_index = My402CListFind(&clist, obj);
+            if ((found_index != 0) != (found != NULL)) {
+                ok = FALSE;
+            } else if (found != NULL) {
+                ok = My402CListObj(&clist, found_index) == obj && clist_index(&clist, found_index) == ref_index(&ref, found);
+            }
+        } else {
+            My402CListUnlink(&clist, index);
+            My402ListUnlink(&ref, elem);
+            elem = NULL;
+        }
+        if (elem != NULL && My402CListObj(&clist, index) != elem->obj) {
+            ok = FALSE;
+        }
+        if (rand() % 1000 == 0) {
+            ok = ok && My402CListReserve(&clist, My402ListLength(&ref) + rand() % 100);
+        } else if (rand() % 1000 == 0) {
+            My402CListUnlinkAll(&clist);
+            My402ListUnlinkAll(&ref);
+        }
+        if (!ok || !same_clist(&clist, &ref)) {
+            check_failed("My402CList", step);
+        }
+    }
+    My402CListFree(&clist);
+    My402ListUnlinkAll(&ref);
+    report_check(MODE_CLIST, "rand", CHECK_STEPS);
+}
+
+// Insert obj into a list sorted by key, after any equal keys.
+void ref_insert_sorted(My402List *ref, void *obj) {
+    My402ListElem *elem = My402ListLast(ref);
+    while (elem != NULL && compare_key(elem->obj, obj) > 0) {
+        elem = My402ListPrev(ref, elem);
+    }
+    if (elem == NULL) {
+        My402ListPrepend(ref, obj);
+    } else {
+        My402ListInsertAfter(ref, obj, elem);
+    }
+}
+
+// The first element whose key equals key's, or NULL.
+My402ListElem *ref_find_key(My402List *ref, void *key) {
+    for (My402ListElem *elem = My402ListFirst(ref); elem != NULL; elem = My402ListNext(ref, elem)) {
+        if (compare_key(elem->obj, key) == 0) {
+            return elem;
+        }
+    }
+    return NULL;
+}
+
+// Same objects in the same order on level 0, walked forwards and backwards, and
+// every express lane in key order and made of nodes that reach that lane.
+int same_skiplist(My402SkipList *sl, My402List *ref) {
+    My402List *list = &(sl->list);
+    if (My402ListLength(list) != My402ListLength(ref)) {
+        return FALSE;
+    }
+    My402ListElem *elem = My402ListFirst(ref);
+    for (My402ListElem *cur = My402ListFirst(list); cur != NULL || elem != NULL; cur = My402ListNext(list, cur), elem = My402ListNext(ref, elem)) {
+        if (cur == NULL || elem == NULL || cur->obj != elem->obj) {
+            return FALSE;
+        }
+    }
+    elem = My402ListLast(ref);
+    for (My402ListElem *cur = My402ListLast(list); cur != NULL || elem != NULL; cur = My402ListPrev(list, cur), elem = My402ListPrev(ref, elem)) {
+        if (cur == NULL || elem == NULL || cur->obj != elem->obj) {
+            return FALSE;
+        }
+    }
+    for (int lane = 0; lane < sl->num_lanes; lane++) {
+        int count = 0;
+        for (My402SkipNode *node = sl->head[lane]; node != NULL; node = node->lanes[lane]) {
+            if (node->num_lanes <= lane || ++count > My402ListLength(list)) {
+                return FALSE;
+            }
+            if (node->lanes[lane] != NULL && compare_key(node->elem.obj, node->lanes[lane]->elem.obj) > 0) {
+                return FALSE;
+            }
+        }
+    }
+    return TRUE;
+}
+
+// My402SkipList against a My402List kept sorted by hand. Half the inserts ask for
+// duplicate detection, which must reject a key that is already there and hand back
+// its first object; the others must go in after equal keys. Find must return the
+// first object with the key.
+void check_skiplist(void) {
+    My402SkipList sl;
+    My402List ref;
+    My402SkipListInit(&sl, compare_key);
+    My402ListInit(&ref);
+    for (int i = 0; i < CHECK_OBJS; i++) {
+        check_keys[i] = rand() % (CHECK_MAX_MEMBERS / 2);
+    }
+    for (long step = 0; step < CHECK_STEPS; step++) {
+        int n = My402ListLength(&ref);
+        int op = check_op(n);
+        void *obj = check_keys + rand() % CHECK_OBJS;
+        int ok = TRUE;
+        if (op <= 1) {
+            ok = My402SkipListInsert(&sl, obj, NULL);
+            ref_insert_sorted(&ref, obj);
+        } else if (op <= 3) {
+            My402ListElem *found = ref_find_key(&ref, obj);
+            void *dup;
+            if (My402SkipListInsert(&sl, obj, &dup)) {
+                ok = found == NULL;
+                ref_insert_sorted(&ref, obj);
+            } else {
+                ok = found != NULL && dup == found->obj;
+            }
+        } else if (op == 4) {
+            My402ListElem *found = ref_find_key(&ref, obj);
+            My402ListElem *elem = My402SkipListFind(&sl, obj);
+            ok = found == NULL ? elem == NULL : elem != NULL && elem->obj == found->obj;
+        } else {
+            int k = rand() % n;
+            My402SkipListUnlink(&sl, ref_at(&(sl.list), k));
+            My402ListUnlink(&ref, ref_at(&ref, k));
+        }
+        if (rand() % 1000 == 0) {
+            My402SkipListDestroy(&sl, NULL);
+            My402ListUnlinkAll(&ref);
+        }
+        if (!ok || !same_skiplist(&sl, &ref)) {
+            check_failed("My402SkipList", step);
+        }
+    }
+    My402SkipListDestroy(&sl, NULL);
+    My402ListUnlinkAll(&ref);
+    report_check(MODE_SKIPLIST, "rand", CHECK_STEPS);
+}
+#endif
+
+void bench_size(long n) {
+    double start;
+    long allocs;
+
+    // Growing a list from empty.
+    const char *grow_ops[] = { "Append", "Prepend" };
+    for (int op = 0; op < 2; op++) {
+        init_list();
+        allocs = num_allocs;
+        start = now_ns();
+        for (long i = 0; i < n; i++) {
+            if (op == 0) {
+                append(objs + i);
+            } else {
+                prepend(objs + i);
+            }
+        }
+        report(grow_ops[op], mode, "seq", n, now_ns() - start, num_allocs - allocs, n);
+        free_list();
+    }
+
+    // Inserting next to existing elements: right after the previous insert, or at random.
+    const char *insert_ops[] = { "InsertAfter", "InsertBefore" };
+    for (int op = 0; op < 2; op++) {
+        for (int random = 0; random < 2; random++) {
+            init_list();
+            fill(n);
+            shuffle(order, n);
+            My402ListElem *at = My402ListFirst(list);
+            allocs = num_allocs;
+            start = now_ns();
+            for (long i = 0; i < n; i++) {
+                if (random) {
+                    at = elems[order[i]];
+                }
+                if (op == 0) {
+                    insert_after(objs + i, at);
+                    at = random ? at : My402ListNext(list, at);
+                } else {
+                    insert_before(objs + i, at);
+                }
+            }
+            report(insert_ops[op], mode, random ? "rand" : "seq", n, now_ns() - start, num_allocs - allocs, n);
+            free_list();
+        }
+    }
+
+    // Unlinking every element, from the head or in random order.
+    for (int random = 0; random < 2; random++) {
+        init_list();
+        fill(n);
+        shuffle(order, n);
+        allocs = num_allocs;
+        start = now_ns();
+        for (long i = 0; i < n; i++) {
+            unlink_elem(random ? elems[order[i]] : My402ListFirst(list));
+        }
+        report("Unlink", mode, random ? "rand" : "seq", n, now_ns() - start, num_allocs - allocs, n);
+        free_list();
+    }
+
+    // Find for objects at random positions. Without the index each lookup is a scan,
+    // so cap the number of lookups to keep the run short.
+    init_list();
+    fill(n);
+    long lookups = mode == MODE_INDEXED ? n : max(1, min(n, 20000000 / n));
+    allocs = num_allocs;
+    start = now_ns();
+    for (long i = 0; i < lookups; i++) {
+        if (find(objs + rand() % n) == NULL) {
+            fprintf(stderr, "Error: Find missed an object on the list\n");
+            exit(1);
+        }
+    }
+    report("Find", mode, "rand", n, now_ns() - start, num_allocs - allocs, lookups);
+
+    // Full First/Next traversal, with the elements in allocation order and then
+    // relinked into a random order (what a sorted list looks like in memory).
+    for (int random = 0; random < 2; random++) {
+        if (random) {
+            shuffle(order, n);
+            My402ListSort(list, compare_order, NULL);
+        }
+        int rounds = max(1, 10000000 / n);
+        long sum = 0;
+        allocs = num_allocs;
+        start = now_ns();
+        for (int r = 0; r < rounds; r++) {
+            for (My402ListElem *elem = My402ListFirst(list); elem != NULL; elem = My402ListNext(list, elem)) {
+                sum += (char*) elem->obj - objs;
+            }
+        }
+        report("Iterate", mode, random ? "rand" : "seq", n, now_ns() - start, num_allocs - allocs, (long) rounds * n);
+        if (sum != (long) rounds * n * (n - 1) / 2) {
+            fprintf(stderr, "Error: Traversal missed elements\n");
+            exit(1);
+        }
+        if (mode == MODE_MALLOC) {
+            // The same walk through the MY402LIST_TYPED wrappers, which read the list inline.
+            sum = 0;
+            allocs = num_allocs;
+            start = now_ns();
+            for (int r = 0; r < rounds; r++) {
+                for (My402ListElem *elem = ObjListFirst(&plain); elem != NULL; elem = ObjListNext(&plain, elem)) {
+                    sum += ObjListObj(elem) - objs;
+                }
+            }
+            report("Iterate", MODE_TYPED, random ? "rand" : "seq", n, now_ns() - start, num_allocs - allocs, (long) rounds * n);
+            if (sum != (long) rounds * n * (n - 1) / 2) {
+                fprintf(stderr, "Error: Traversal missed elements\n");
+                exit(1);
+            }
+        }
+    }
+
+    allocs = num_allocs;
+    start = now_ns();
+    unlink_all();
+    report("UnlinkAll", mode, "seq", n, now_ns() - start, num_allocs - allocs, n);
+    free_list();
+}
+
+#ifdef LISTBENCH_SIBLINGS
+// My402UList built by appends, then full scans chunk by chunk and with First/Next,
+// to set against the My402List Iterate lines for the same n.
+void bench_ulist(long n) {
+    My402UList ulist;
+    My402UListInit(&ulist);
+    long allocs = num_allocs;
+    double start = now_ns();
+    for (long i = 0; i < n; i++) {
+        My402UListAppend(&ulist, objs + i);
+    }
+    report("Append", MODE_ULIST, "seq", n, now_ns() - start, num_allocs - allocs, n);
+
+    int rounds = max(1, 10000000 / n);
+    for (int chunks = 1; chunks >= 0; chunks--) {
+        long sum = 0;
+        allocs = num_allocs;
+        start = now_ns();
+        for (int r = 0; r < rounds; r++) {
+            if (chunks) {
+                for (My402UListChunk *chunk = My402UListFirstChunk(&ulist); chunk != NULL; chunk = My402UListNextChunk(&ulist, chunk)) {
+                    for (int i = 0; i < chunk->num_objs; i++) {
+                        sum += (char*) chunk->objs[i] - objs;
+                    }
+                }
+            } else {
+                My402UListPos pos;
+                for (void *obj = My402UListFirst(&ulist, &pos); obj != NULL; obj = My402UListNext(&ulist, &pos)) {
+                    sum += (char*) obj - objs;
+                }
+            }
+        }
+        report("Iterate", MODE_ULIST, chunks ? "chunks" : "seq", n, now_ns() - start, num_allocs - allocs, (long) rounds * n);
+        if (sum != (long) rounds * n * (n - 1) / 2) {
+            fprintf(stderr, "Error: Traversal missed elements\n");
+            exit(1);
+        }
+    }
+    My402UListUnlinkAll(&ulist);
+}
+
+// My402CList grown by appends and sized up front, and the bytes per element each
+// holds, against what malloc() hands out for a plain My402List of the same length.
+void bench_clist(long n) {
+    My402List list;
+    My402ListInit(&list);
+    size_t in_use = mallinfo2().uordblks;
+    for (long i = 0; i < n; i++) {
+        My402ListAppend(&list, objs + i);
+    }
+    report_memory(MODE_MALLOC, "seq", n, mallinfo2().uordblks - in_use);
+    My402ListUnlinkAll(&list);
+
+    for (int reserved = 0; reserved < 2; reserved++) {
+        My402CList clist;
+        My402CListInit(&clist);
+        if (reserved) {
+            My402CListReserve(&clist, n);
+        }
+        long allocs = num_allocs;
+        double start = now_ns();
+        for (long i = 0; i < n; i++) {
+            My402CListAppend(&clist, objs + i);
+        }
+        report("Append", MODE_CLIST, "seq", n, now_ns() - start, num_allocs - allocs, n);
+        report_memory(MODE_CLIST, reserved ? "reserved" : "grown", n, My402CListMemory(&clist));
+        if (!reserved) {
+            int rounds = max(1, 10000000 / n);
+            long sum = 0;
+            allocs = num_allocs;
+            start = now_ns();
+            for (int r = 0; r < rounds; r++) {
+                for (My402CListIndex index = My402CListFirst(&clist); index != 0; index = My402CListNext(&clist, index)) {
+                    sum += (char*) My402CListObj(&clist, index) - objs;
+                }
+            }
+            report("Iterate", MODE_CLIST, "seq", n, now_ns() - start, num_allocs - allocs, (long) rounds * n);
+            if (sum != (long) rounds * n * (n - 1) / 2) {
+                fprintf(stderr, "Error: Traversal missed elements\n");
+                exit(1);
+            }
+        }
+        My402CListFree(&clist);
+    }
+}
+
+// My402SkipList filled with n objects in random key order, then looked up by key.
+void bench_skiplist(long n) {
+    My402SkipList sl;
+    My402SkipListInit(&sl, compare_order);
+    shuffle(order, n);
+    long allocs = num_allocs;
+    double start = now_ns();
+    for (long i = 0; i < n; i++) {
+        My402SkipListInsert(&sl, objs + i, NULL);
+    }
+    report("Insert", MODE_SKIPLIST, "rand", n, now_ns() - start, num_allocs - allocs, n);
+
+    allocs = num_allocs;
+    start = now_ns();
+    for (long i = 0; i < n; i++) {
+        void *obj = objs + rand() % n;
+        My402ListElem *elem = My402SkipListFind(&sl, obj);
+        if (elem == NULL || elem->obj != obj) {
+            fprintf(stderr, "Error: Find missed an object on the list\n");
+            exit(1);
+        }
+    }
+    report("Find", MODE_SKIPLIST, "rand", n, now_ns() - start, num_allocs - allocs, n);
+    My402SkipListDestroy(&sl, NULL);
+}
+#endif
+
+int main(int argc, char *argv[]) {
+    long sizes[16] = { 1000, 100000, 1000000 };
+    int num_sizes = 3;
+    int c;
+    while ((c = getopt(argc, argv, "s:n:")) != -1) {
+        switch (c) {
+            case 's':
+                seed = strtoul(optarg, NULL, 0);
+                break;
+            case 'n':
+                num_sizes = 0;
+                for (char *token = strtok(optarg, ","); token != NULL && num_sizes < 16; token = strtok(NULL, ",")) {
+                    sizes[num_sizes] = strtol(token, NULL, 0);
+                    if (sizes[num_sizes] <= 0) {
+                        usage();
+                    }
+                    num_sizes++;
+                }
+                break;
+            default:
+                usage();
+        }
+    }
+    if (optind != argc || num_sizes == 0) {
+        usage();
+    }
+    srand(seed);
+    fprintf(stdout, "# listbench seed=%u\n", seed);
+    check_moves();
+    check_sort();
+    check_destroy();
+    check_indexed();
+#ifdef LISTBENCH_SIBLINGS
+    check_ulist();
+    check_clist();
+    check_skiplist();
+#endif
+    for (int i = 0; i < num_sizes; i++) {
+        long n = sizes[i];
+        objs = malloc(n);
+        elems = malloc(n * sizeof(My402ListElem*));
+        order = malloc(n * sizeof(long));
+        for (long j = 0; j < n; j++) {
+            order[j] = j;
+        }
+        for (mode = MODE_MALLOC; mode <= MODE_INDEXED; mode++) {
+            bench_size(n);
+        }
+#ifdef LISTBENCH_SIBLINGS
+        bench_ulist(n);
+        bench_clist(n);
+        bench_skiplist(n);
+#endif
+        free(objs);
+        free(elems);
+        free(order);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sched.h>
+#include "cs402.h"
+#include "my402lfqueue.h"
+
+#define SPIN_LIMIT 64
+
+static int WaiterInit(My402LFWaiter *waiter) {
+    atomic_init(&waiter->sleeping, 0);
+    atomic_init(&waiter->closed, 0);
+    if (pthread_mutex_init(&waiter->mutex, NULL) != 0) {
+        return FALSE;
+    }
+    if (pthread_cond_init(&waiter->cv, NULL) != 0) {
+        pthread_mutex_destroy(&waiter->mutex);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static void WaiterFree(My402LFWaiter *waiter) {
+    pthread_cond_destroy(&waiter->cv);
+    pthread_mutex_destroy(&waiter->mutex);
+}
+
+// Called by a producer after publishing. The fence pairs with the one in Wait so that
+// either the producer sees the consumer asleep or the consumer sees the new object.
+static void Wake(My402LFWaiter *waiter) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&waiter->sleeping, memory_order_relaxed)) {
+        pthread_mutex_lock(&waiter->mutex);
+        pthread_cond_signal(&waiter->cv);
+        pthread_mutex_unlock(&waiter->mutex);
+    }
+}
+
+static void *Wait(My402LFWaiter *waiter, void *(*pop)(void*), void *queue) {
+    while (1) {
+        // Spin briefly first; a producer is usually only a few hundred cycles away.
+        for (int i = 0; i < SPIN_LIMIT; i++) {
+            void *obj = pop(queue);
+            if (obj != NULL) {
+                return obj;
+            }
+            sched_yield();
+        }
+        if (atomic_load(&waiter->closed)) {
+            // Re-check, a Push may have landed between the Pop above and Close.
+            return pop(queue);
+        }
+        pthread_mutex_lock(&waiter->mutex);
+        atomic_store_explicit(&waiter->sleeping, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        void *obj = pop(queue);
+        if (obj == NULL && !atomic_load(&waiter->closed)) {
+            pthread_cond_wait(&waiter->cv, &waiter->mutex);
+        }
+        atomic_store_explicit(&waiter->sleeping, 0, memory_order_relaxed);
+        pthread_mutex_unlock(&waiter->mutex);
+        if (obj != NULL) {
+            return obj;
+        }
+    }
+}
+
+static void Close(My402LFWaiter *waiter) {
+    pthread_mutex_lock(&waiter->mutex);
+    atomic_store(&waiter->closed, 1);
+    pthread_cond_broadcast(&waiter->cv);
+    pthread_mutex_unlock(&waiter->mutex);
+}
+
+static int IsPowerOfTwo(int n) {
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+int My402MpscQueueInit(My402MpscQueue *queue, int num_slots) {
+    if (!IsPowerOfTwo(num_slots)) {
+        return FALSE;
+    }
+    queue->cells = malloc(num_slots * sizeof(My402MpscCell));
+    if (queue->cells == NULL) {
+        return FALSE;
+    }
+    for (int i = 0; i < num_slots; i++) {
+        atomic_init(&queue->cells[i].seq, i);
+        queue->cells[i].obj = NULL;
+    }
+    queue->mask = num_slots - 1;
+    atomic_init(&queue->tail, 0);
+    queue->head = 0;
+    if (!WaiterInit(&queue->waiter)) {
+        free(queue->cells);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void My402MpscQueueFree(My402MpscQueue *queue) {
+    WaiterFree(&queue->waiter);
+    free(queue->cells);
+    queue->cells = NULL;
+}
+
+int My402MpscQueuePush(My402MpscQueue *queue, void *obj) {
+    size_t pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    My402MpscCell *cell;
+    while (1) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+        if (diff == 0) {
+            // The slot is free for this lap; try to claim it.
+            if (atomic_compare_exchange_weak_explicit(&queue->tail, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The consumer has not freed this slot from the previous lap yet.
+            return FALSE;
+        } else {
+            pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+        }
+    }
+    cell->obj = obj;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    Wake(&queue->waiter);
+    return TRUE;
+}
+
+void *My402MpscQueuePop(My402MpscQueue *queue) {
+    My402MpscCell *cell = &queue->cells[queue->head & queue->mask];
+    size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+    if (seq != queue->head + 1) {
+        return NULL;
+    }
+    void *obj = cell->obj;
+    // Hand the slot back to producers for the next lap.
+    atomic_store_explicit(&cell->seq, queue->head + queue->mask + 1, memory_order_release);
+    queue->head++;
+    return obj;
+}
+
+static void *MpscPop(void *queue) {
+    return My402MpscQueuePop((My402MpscQueue*) queue);
+}
+
+void *My402MpscQueuePopWait(My402MpscQueue *queue) {
+    return Wait(&queue->waiter, MpscPop, queue);
+}
+
+// Call once every producer is done; PopWait then returns NULL when the queue is empty.
+void My402MpscQueueClose(My402MpscQueue *queue) {
+    Close(&queue->waiter);
+}
+
+int My402SpscQueueInit(My402SpscQueue *queue, int num_slots) {
+    if (!IsPowerOfTwo(num_slots)) {
+        return FALSE;
+    }
+    queue->slots = malloc(num_slots * sizeof(void*));
+    if (queue->slots == NULL) {
+        return FALSE;
+    }
+    queue->mask = num_slots - 1;
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->head, 0);
+    if (!WaiterInit(&queue->waiter)) {
+        free(queue->slots);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void My402SpscQueueFree(My402SpscQueue *queue) {
+    WaiterFree(&queue->waiter);
+    free(queue->slots);
+    queue->slots = NULL;
+}
+
+int My402SpscQueuePush(My402SpscQueue *queue, void *obj) {
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (tail - head > queue->mask) {
+        return FALSE;
+    }
+    queue->slots[tail & queue->mask] = obj;
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    Wake(&queue->waiter);
+    return TRUE;
+}
+
+void *My402SpscQueuePop(My402SpscQueue *queue) {
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    if (head == tail) {
+        return NULL;
+    }
+    void *obj = queue->slots[head & queue->mask];
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return obj;
+}
+
+static void *SpscPop(void *queue) {
+    return My402SpscQueuePop((My402SpscQueue*) queue);
+}
+
+void *My402SpscQueuePopWait(My402SpscQueue *queue) {
+    return Wait(&queue->waiter, SpscPop, queue);
+}
+
+void My402SpscQueueClose(My402SpscQueue *queue) {
+    Close(&queue->waiter);
+}
@@ -0,0 +1,71 @@
+#ifndef _MY402LFQUEUE_H_
+#define _MY402LFQUEUE_H_
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "cs402.h"
+
+/*
+ * Lock-free bounded FIFOs for handing objects between threads without a
+ * shared mutex.  Both are fixed-size rings whose size (a power of two) is
+ * chosen at Init time; Push returns FALSE instead of growing when full.
+ *
+ * My402MpscQueue accepts Push from any number of threads and Pop from one.
+ * Each slot carries a sequence number: a producer claims a slot with a CAS
+ * on tail and publishes it by bumping the slot's sequence, so Push and Pop
+ * each take effect at a single atomic step.  Slots are taken in order, so a
+ * producer preempted between claiming and publishing its slot stalls the
+ * consumer until it publishes, even if later slots are already published.
+ *
+ * My402SpscQueue is the cheaper one-producer/one-consumer version.
+ *
+ * PopWait blocks while the queue is empty.  The mutex and condition variable
+ * are only touched when the consumer actually goes to sleep; a Push checks a
+ * flag and signals only if the consumer is asleep.  After Close, PopWait
+ * returns NULL once the queue has drained.  NULL cannot be pushed, since Pop
+ * uses it to mean empty.
+ */
+typedef struct tagMy402LFWaiter {
+    atomic_int sleeping;
+    atomic_int closed;
+    pthread_mutex_t mutex;
+    pthread_cond_t cv;
+} My402LFWaiter;
+
+typedef struct tagMy402MpscCell {
+    atomic_size_t seq;
+    void *obj;
+} My402MpscCell;
+
+typedef struct tagMy402MpscQueue {
+    My402MpscCell *cells;
+    size_t mask;
+    _Alignas(64) atomic_size_t tail;    /* shared by producers */
+    _Alignas(64) size_t head;           /* owned by the consumer */
+    My402LFWaiter waiter;
+} My402MpscQueue;
+
+typedef struct tagMy402SpscQueue {
+    void **slots;
+    size_t mask;
+    _Alignas(64) atomic_size_t tail;    /* written by the producer */
+    _Alignas(64) atomic_size_t head;    /* written by the consumer */
+    My402LFWaiter waiter;
+} My402SpscQueue;
+
+extern int  My402MpscQueueInit(My402MpscQueue*, int num_slots);
+extern void My402MpscQueueFree(My402MpscQueue*);
+extern int  My402MpscQueuePush(My402MpscQueue*, void*);
+extern void *My402MpscQueuePop(My402MpscQueue*);
+extern void *My402MpscQueuePopWait(My402MpscQueue*);
+extern void My402MpscQueueClose(My402MpscQueue*);
+
+extern int  My402SpscQueueInit(My402SpscQueue*, int num_slots);
+extern void My402SpscQueueFree(My402SpscQueue*);
+extern int  My402SpscQueuePush(My402SpscQueue*, void*);
+extern void *My402SpscQueuePop(My402SpscQueue*);
+extern void *My402SpscQueuePopWait(My402SpscQueue*);
+extern void My402SpscQueueClose(My402SpscQueue*);
+
+#endif /*_MY402LFQUEUE_H_*/
@@ -25,6 +25,7 @@
 #ifndef _MY402LIST_H_
 #define _MY402LIST_H_
 
+#include <stdio.h>
 #include "cs402.h"
 
 typedef struct tagMy402ListElem {
@@ -54,6 +55,7 @@ typedef struct tagMy402List {
     My402ListElem *(*Prev)(struct tagMy402List *, My402ListElem *cur);
 
     My402ListElem *(*Find)(struct tagMy402List *, void *obj);
+
 } My402List;
 
 extern int  My402ListLength(My402List*);
@@ -73,6 +75,105 @@ extern My402ListElem *My402ListPrev(My402List*, My402ListElem*);
 
 extern My402ListElem *My402ListFind(My402List*, void*);
 
+/*
+ * Bulk moves between lists.  These relink the anchors and never allocate or
+ * free a node, so both lists must get their nodes the same way (both plain,
+ * or both from the same My402ListPool, see my402poollist.h).  A NULL elem
+ * means the end of the list, as in My402ListInsertAfter().
+ *
+ * Concat appends all of src to list.  Splice inserts all of src after elem.
+ * MoveRange moves the run first..last (inclusive) of src after elem; pass the
+ * number of elements in the run as count to keep it O(1), or 0 to have it
+ * counted.
+ */
+extern int  My402ListConcat(My402List*, My402List *src);
+extern int  My402ListSplice(My402List*, My402ListElem*, My402List *src);
+extern int  My402ListMoveRange(My402List*, My402ListElem*, My402List *src, My402ListElem *first, My402ListElem *last, int count);
+
+/*
+ * Stable bottom-up merge sort.  The existing elements are relinked in place,
+ * so nothing is allocated.  cmp returns <0, 0 or >0 like strcmp().  If dup is
+ * not NULL, it is called once for every pair of adjacent objects that compare
+ * equal after sorting, earlier object (in original list order) first.
+ */
+extern void My402ListSort(My402List*, int (*cmp)(void*, void*), void (*dup)(void*, void*));
+
 extern int My402ListInit(My402List*);
 
+/*
+ * Unlink every element and call destructor (if not NULL) on each obj.  The
+ * list is left empty and can be reused.
+ */
+extern void My402ListDestroy(My402List*, void (*destructor)(void*));
+
+/*
+ * Instrumentation, compiled in only with -DMY402LIST_STATS (see the STATS
+ * variable in the Makefile).  Every list counts the calls made to each API
+ * function, remembers its peak num_members, and keeps two histograms: how
+ * many elements each linear Find compared, and how many elements each
+ * First..Next (or Last..Prev) traversal visited.  Bucket 0 holds zero-length
+ * scans and bucket b > 0 holds lengths 2^(b-1) .. 2^b - 1.  A traversal ends
+ * when Next/Prev returns NULL or a new one is started.
+ *
+ * The counters live in a table inside my402list.c keyed by the list's
+ * address, so My402List has the same layout with or without the flag.  An
+ * entry is reset by My402ListInit().  The table itself is locked, but the
+ * counters are not atomic; they are updated under whatever lock guards the
+ * list.
+ *
+ * My402ListStatsPrint() prints list's counters to fp, labelled with name.
+ * It is a no-op without MY402LIST_STATS.
+ */
+extern void My402ListStatsPrint(My402List*, const char *name, FILE *fp);
+
+/*
+ * Read-only accessors used by the typed wrappers below.  They are plain field
+ * reads normally, and calls into my402list.c when the calls are being counted.
+ */
+#ifdef MY402LIST_STATS
+#define MY402LIST_LENGTH(list) My402ListLength(list)
+#define MY402LIST_EMPTY(list) My402ListEmpty(list)
+#define MY402LIST_FIRST(list) My402ListFirst(list)
+#define MY402LIST_LAST(list) My402ListLast(list)
+#define MY402LIST_NEXT(list, elem) My402ListNext(list, elem)
+#define MY402LIST_PREV(list, elem) My402ListPrev(list, elem)
+#else
+#define MY402LIST_LENGTH(list) ((list)->num_members)
+#define MY402LIST_EMPTY(list) ((list)->num_members <= 0)
+#define MY402LIST_FIRST(list) (MY402LIST_EMPTY(list) ? NULL : (list)->anchor.next)
+#define MY402LIST_LAST(list) (MY402LIST_EMPTY(list) ? NULL : (list)->anchor.prev)
+#define MY402LIST_NEXT(list, elem) ((elem)->next == &(list)->anchor ? NULL : (elem)->next)
+#define MY402LIST_PREV(list, elem) ((elem)->prev == &(list)->anchor ? NULL : (elem)->prev)
+#endif
+
+/*
+ * MY402LIST_TYPED(Name, Type) declares Name, a My402List holding Type
+ * objects, together with static inline Name##Init, Name##Append, ...,
+ * Name##First/Next and Name##Obj wrappers.  The wrappers are type-checked
+ * against Type, and the read-only ones (Length, Empty, First, Last, Next,
+ * Prev, Obj) are inline, so a traversal loop compiles to plain pointer
+ * walks instead of a call per step.  With MY402LIST_STATS they call through
+ * instead, so that every step is counted.  The underlying My402List is the
+ * "list" member and can be passed to the rest of the API (Sort, Destroy, ...).
+ */
+#define MY402LIST_TYPED(Name, Type) \
+    typedef struct tag##Name { \
+        My402List list; \
+    } Name; \
+    static inline int Name##Init(Name *l) { return My402ListInit(&l->list); } \
+    static inline int Name##Length(Name *l) { return MY402LIST_LENGTH(&l->list); } \
+    static inline int Name##Empty(Name *l) { return MY402LIST_EMPTY(&l->list); } \
+    static inline int Name##Append(Name *l, Type *obj) { return My402ListAppend(&l->list, obj); } \
+    static inline int Name##Prepend(Name *l, Type *obj) { return My402ListPrepend(&l->list, obj); } \
+    static inline void Name##Unlink(Name *l, My402ListElem *elem) { My402ListUnlink(&l->list, elem); } \
+    static inline void Name##UnlinkAll(Name *l) { My402ListUnlinkAll(&l->list); } \
+    static inline int Name##InsertAfter(Name *l, Type *obj, My402ListElem *elem) { return My402ListInsertAfter(&l->list, obj, elem); } \
+    static inline int Name##InsertBefore(Name *l, Type *obj, My402ListElem *elem) { return My402ListInsertBefore(&l->list, obj, elem); } \
+    static inline My402ListElem *Name##First(Name *l) { return MY402LIST_FIRST(&l->list); } \
+    static inline My402ListElem *Name##Last(Name *l) { return MY402LIST_LAST(&l->list); } \
+    static inline My402ListElem *Name##Next(Name *l, My402ListElem *elem) { return MY402LIST_NEXT(&l->list, elem); } \
+    static inline My402ListElem *Name##Prev(Name *l, My402ListElem *elem) { return MY402LIST_PREV(&l->list, elem); } \
+    static inline My402ListElem *Name##Find(Name *l, Type *obj) { return My402ListFind(&l->list, obj); } \
+    static inline Type *Name##Obj(My402ListElem *elem) { return (Type*) elem->obj; }
+
 #endif /*_MY402LIST_H_*/
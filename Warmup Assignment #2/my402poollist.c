@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "cs402.h"
+#include "my402list.h"
+#include "my402poollist.h"
+
+typedef struct tagMy402ListChunk {
+    struct tagMy402ListChunk *next;
+    My402ListElem elems[];
+} My402ListChunk;
+
+static My402ListElem *AllocElem(My402ListPool *pool) {
+    if (pool->free_elems == NULL) {
+        My402ListChunk *chunk = malloc(sizeof(My402ListChunk) + pool->nodes_per_chunk * sizeof(My402ListElem));
+        if (chunk == NULL) {
+            return NULL;
+        }
+        chunk->next = pool->chunks;
+        pool->chunks = chunk;
+        pool->num_chunks++;
+        // Thread the new nodes onto the free list, lowest address first.
+        for (int i = pool->nodes_per_chunk - 1; i >= 0; i--) {
+            chunk->elems[i].next = pool->free_elems;
+            pool->free_elems = &(chunk->elems[i]);
+        }
+        pool->num_cached += pool->nodes_per_chunk;
+    } else {
+        pool->num_recycled++;
+    }
+    My402ListElem *elem = pool->free_elems;
+    pool->free_elems = elem->next;
+    pool->num_cached--;
+    pool->num_live++;
+    return elem;
+}
+
+static void FreeElem(My402ListPool *pool, My402ListElem *elem) {
+    elem->next = pool->free_elems;
+    pool->free_elems = elem;
+    pool->num_cached++;
+    pool->num_live--;
+}
+
+// Link a new element for obj in after prev, which may be the anchor.
+static int LinkAfter(My402PoolList *pl, void *obj, My402ListElem *prev) {
+    My402ListElem *elem = AllocElem(pl->pool);
+    if (elem == NULL) {
+        return FALSE;
+    }
+    My402ListElem *next = prev->next;
+    elem->obj = obj;
+    elem->next = next;
+    elem->prev = prev;
+    prev->next = elem;
+    next->prev = elem;
+    pl->list.num_members++;
+    return TRUE;
+}
+
+int My402PoolListAppend(My402PoolList *pl, void *obj) {
+    return LinkAfter(pl, obj, (pl->list.anchor).prev);
+}
+
+int My402PoolListPrepend(My402PoolList *pl, void *obj) {
+    return LinkAfter(pl, obj, &(pl->list.anchor));
+}
+
+int My402PoolListInsertAfter(My402PoolList *pl, void *obj, My402ListElem *elem) {
+    return LinkAfter(pl, obj, elem == NULL ? (pl->list.anchor).prev : elem);
+}
+
+int My402PoolListInsertBefore(My402PoolList *pl, void *obj, My402ListElem *elem) {
+    return LinkAfter(pl, obj, elem == NULL ? &(pl->list.anchor) : elem->prev);
+}
+
+void My402PoolListUnlink(My402PoolList *pl, My402ListElem *elem) {
+    if (pl->list.num_members <= 0) {
+        return;
+    }
+    My402ListElem *prev = elem->prev;
+    My402ListElem *next = elem->next;
+    prev->next = next;
+    next->prev = prev;
+    FreeElem(pl->pool, elem);
+    pl->list.num_members--;
+}
+
+// Release every element in one pass, calling destructor (if any) on each obj. If
+// release_pool is set and every live node of the pool belongs to this list, the pool's
+// chunks are handed back wholesale, so the nodes are never visited unless there is a
+// destructor.
+static void ReleaseAll(My402PoolList *pl, void (*destructor)(void*), int release_pool) {
+    My402List *list = &(pl->list);
+    My402ListPool *pool = pl->pool;
+    My402ListElem *elem = (list->anchor).next;
+    if (release_pool && pool->num_live == list->num_members) {
+        if (destructor != NULL) {
+            for (; elem != &(list->anchor); elem = elem->next) {
+                destructor(elem->obj);
+            }
+        }
+        My402ListPoolFree(pool);
+    } else {
+        while (elem != &(list->anchor)) {
+            My402ListElem *next = elem->next;
+            if (destructor != NULL) {
+                destructor(elem->obj);
+            }
+            elem->next = pool->free_elems;
+            pool->free_elems = elem;
+            elem = next;
+        }
+        pool->num_live -= list->num_members;
+        pool->num_cached += list->num_members;
+    }
+    list->num_members = 0;
+    (list->anchor).next = &(list->anchor);
+    (list->anchor).prev = &(list->anchor);
+}
+
+void My402PoolListUnlinkAll(My402PoolList *pl) {
+    ReleaseAll(pl, NULL, FALSE);
+}
+
+void My402PoolListDestroy(My402PoolList *pl, void (*destructor)(void*)) {
+    ReleaseAll(pl, destructor, TRUE);
+}
+
+int My402PoolListInit(My402PoolList *pl, My402ListPool *pool) {
+    if (!My402ListInit(&(pl->list))) {
+        return FALSE;
+    }
+    pl->pool = pool;
+    return TRUE;
+}
+
+int My402ListPoolInit(My402ListPool *pool, int nodes_per_chunk) {
+    if (nodes_per_chunk <= 0) {
+        return FALSE;
+    }
+    memset(pool, 0, sizeof(My402ListPool));
+    pool->nodes_per_chunk = nodes_per_chunk;
+    return TRUE;
+}
+
+// Every list using the pool must be empty (or abandoned) before this is called.
+void My402ListPoolFree(My402ListPool *pool) {
+    My402ListChunk *chunk = pool->chunks;
+    while (chunk != NULL) {
+        My402ListChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    pool->chunks = NULL;
+    pool->free_elems = NULL;
+    pool->num_chunks = 0;
+    pool->num_live = 0;
+    pool->num_cached = 0;
+}
@@ -0,0 +1,82 @@
+#ifndef _MY402POOLLIST_H_
+#define _MY402POOLLIST_H_
+
+#include "cs402.h"
+#include "my402list.h"
+
+/*
+ * Free-list allocator for My402ListElem.  Nodes are carved out of chunks of
+ * nodes_per_chunk elements and recycled on unlink instead of going back to
+ * free().  A pool may be shared by several lists (e.g. two queues that pass
+ * objects back and forth); it does no locking of its own, so lists sharing a
+ * pool must be protected by the same lock.
+ */
+typedef struct tagMy402ListPool {
+    int nodes_per_chunk;
+    My402ListElem *free_elems;  /* linked through next */
+    void *chunks;
+
+    int num_chunks;             /* chunks obtained from malloc() */
+    int num_live;               /* nodes currently on some list */
+    int num_cached;             /* nodes sitting in free_elems */
+    long num_recycled;          /* allocations served from free_elems */
+} My402ListPool;
+
+/*
+ * A My402List whose nodes come from a My402ListPool.  The "list" member can
+ * be read with the usual My402ListFirst/Next/... calls, sorted with
+ * My402ListSort(), and moved with My402ListConcat/Splice/MoveRange to and
+ * from lists on the same pool, but elements must only be added or removed
+ * through the My402PoolList functions, since its nodes were not malloc'd.
+ * Calls made through these functions are not seen by MY402LIST_STATS.
+ */
+typedef struct tagMy402PoolList {
+    My402List list;
+    My402ListPool *pool;
+} My402PoolList;
+
+extern int  My402ListPoolInit(My402ListPool*, int nodes_per_chunk);
+extern void My402ListPoolFree(My402ListPool*);
+
+extern int  My402PoolListInit(My402PoolList*, My402ListPool*);
+
+extern int  My402PoolListAppend(My402PoolList*, void*);
+extern int  My402PoolListPrepend(My402PoolList*, void*);
+extern void My402PoolListUnlink(My402PoolList*, My402ListElem*);
+extern void My402PoolListUnlinkAll(My402PoolList*);
+extern int  My402PoolListInsertAfter(My402PoolList*, void*, My402ListElem*);
+extern int  My402PoolListInsertBefore(My402PoolList*, void*, My402ListElem*);
+
+/*
+ * Unlink every element and call destructor (if not NULL) on each obj.  If no
+ * other list holds nodes from the pool, the pool's chunks are freed wholesale
+ * instead of node by node.  The list is left empty and can be reused.
+ */
+extern void My402PoolListDestroy(My402PoolList*, void (*destructor)(void*));
+
+/*
+ * MY402POOLLIST_TYPED(Name, Type) is MY402LIST_TYPED for a My402PoolList:
+ * Name##Init takes the pool, and the read-only wrappers are the same inline
+ * field reads.  The underlying My402PoolList is the "list" member.
+ */
+#define MY402POOLLIST_TYPED(Name, Type) \
+    typedef struct tag##Name { \
+        My402PoolList list; \
+    } Name; \
+    static inline int Name##Init(Name *l, My402ListPool *pool) { return My402PoolListInit(&l->list, pool); } \
+    static inline int Name##Length(Name *l) { return MY402LIST_LENGTH(&l->list.list); } \
+    static inline int Name##Empty(Name *l) { return MY402LIST_EMPTY(&l->list.list); } \
+    static inline int Name##Append(Name *l, Type *obj) { return My402PoolListAppend(&l->list, obj); } \
+    static inline int Name##Prepend(Name *l, Type *obj) { return My402PoolListPrepend(&l->list, obj); } \
+    static inline void Name##Unlink(Name *l, My402ListElem *elem) { My402PoolListUnlink(&l->list, elem); } \
+    static inline void Name##UnlinkAll(Name *l) { My402PoolListUnlinkAll(&l->list); } \
+    static inline int Name##InsertAfter(Name *l, Type *obj, My402ListElem *elem) { return My402PoolListInsertAfter(&l->list, obj, elem); } \
+    static inline int Name##InsertBefore(Name *l, Type *obj, My402ListElem *elem) { return My402PoolListInsertBefore(&l->list, obj, elem); } \
+    static inline My402ListElem *Name##First(Name *l) { return MY402LIST_FIRST(&l->list.list); } \
+    static inline My402ListElem *Name##Last(Name *l) { return MY402LIST_LAST(&l->list.list); } \
+    static inline My402ListElem *Name##Next(Name *l, My402ListElem *elem) { return MY402LIST_NEXT(&l->list.list, elem); } \
+    static inline My402ListElem *Name##Prev(Name *l, My402ListElem *elem) { return MY402LIST_PREV(&l->list.list, elem); } \
+    static inline My402ListElem *Name##Find(Name *l, Type *obj) { return My402ListFind(&l->list.list, obj); } \
+    static inline Type *Name##Obj(My402ListElem *elem) { return (Type*) elem->obj; }
+
+#endif /*_MY402POOLLIST_H_*/
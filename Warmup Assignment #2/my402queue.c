@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "cs402.h"
+#include "my402queue.h"
+
+#ifdef MY402LIST_STATS
+static const char *op_names[MY402QUEUE_NUM_OPS] = { "Length", "Empty", "Push", "Pop", "Peek" };
+
+#define COUNT(queue, op) ((queue)->stats.calls[MY402QUEUE_OP_##op]++)
+#define TRACK_PEAK(queue) ((queue)->stats.max_members = max((queue)->stats.max_members, (queue)->num_members))
+#else
+#define COUNT(queue, op)
+#define TRACK_PEAK(queue)
+#endif
+
+int My402QueueLength(My402Queue *queue) {
+    COUNT(queue, LENGTH);
+    return queue->num_members;
+}
+
+int My402QueueEmpty(My402Queue *queue) {
+    COUNT(queue, EMPTY);
+    return queue->num_members <= 0;
+}
+
+// Double the buffer and unwrap the queued objects to the start of it.
+static int Grow(My402Queue *queue) {
+    int num_slots = queue->num_slots == 0 ? 16 : queue->num_slots * 2;
+    void **slots = malloc(num_slots * sizeof(void*));
+    if (slots == NULL) {
+        return FALSE;
+    }
+    int first = min(queue->num_members, queue->num_slots - queue->head);
+    if (first > 0) {
+        memcpy(slots, queue->slots + queue->head, first * sizeof(void*));
+        memcpy(slots + first, queue->slots, (queue->num_members - first) * sizeof(void*));
+    }
+    free(queue->slots);
+    queue->slots = slots;
+    queue->num_slots = num_slots;
+    queue->head = 0;
+    return TRUE;
+}
+
+int My402QueuePush(My402Queue *queue, void *obj) {
+    COUNT(queue, PUSH);
+    if (queue->num_members == queue->num_slots && !Grow(queue)) {
+        return FALSE;
+    }
+    queue->slots[(queue->head + queue->num_members) & (queue->num_slots - 1)] = obj;
+    queue->num_members++;
+    TRACK_PEAK(queue);
+    return TRUE;
+}
+
+void *My402QueuePop(My402Queue *queue) {
+    COUNT(queue, POP);
+    if (queue->num_members <= 0) {
+        return NULL;
+    }
+    void *obj = queue->slots[queue->head];
+    queue->head = (queue->head + 1) & (queue->num_slots - 1);
+    queue->num_members--;
+    return obj;
+}
+
+void *My402QueuePeek(My402Queue *queue) {
+    COUNT(queue, PEEK);
+    return queue->num_members <= 0 ? NULL : queue->slots[queue->head];
+}
+
+int My402QueueInit(My402Queue *queue) {
+    queue->num_members = 0;
+    queue->head = 0;
+    queue->num_slots = 0;
+    queue->slots = NULL;
+#ifdef MY402LIST_STATS
+    memset(&queue->stats, 0, sizeof(My402QueueStats));
+#endif
+    return TRUE;
+}
+
+// Releases the buffer; the queued objects still belong to the caller.
+void My402QueueFree(My402Queue *queue) {
+    free(queue->slots);
+    My402QueueInit(queue);
+}
+
+void My402QueueStatsPrint(My402Queue *queue, const char *name, FILE *fp) {
+#ifdef MY402LIST_STATS
+    fprintf(fp, "My402Queue %s: num_members=%d max_members=%d\n", name, queue->num_members, queue->stats.max_members);
+    fprintf(fp, "    calls:");
+    for (int op = 0; op < MY402QUEUE_NUM_OPS; op++) {
+        if (queue->stats.calls[op] != 0) {
+            fprintf(fp, " %s=%ld", op_names[op], queue->stats.calls[op]);
+        }
+    }
+    fprintf(fp, "\n");
+#endif
+}
@@ -0,0 +1,104 @@
+#ifndef _MY402QUEUE_H_
+#define _MY402QUEUE_H_
+
+#include <stdio.h>
+#include "cs402.h"
+
+/*
+ * FIFO sibling of My402List for lists that are only ever appended at the
+ * tail and removed at the head.  Objects are kept in a growable ring buffer
+ * whose size is a power of two, so Push and Pop do not allocate (except when
+ * the buffer doubles) and queued objects sit in contiguous memory.
+ */
+/*
+ * With -DMY402LIST_STATS (the same flag that instruments My402List) every
+ * queue also counts the calls to each function and remembers its peak
+ * num_members, and the typed wrappers call into my402queue.c so that every
+ * operation is seen.  Without it there are no counters and
+ * My402QueueStatsPrint() prints nothing.
+ */
+#ifdef MY402LIST_STATS
+typedef enum {
+    MY402QUEUE_OP_LENGTH, MY402QUEUE_OP_EMPTY, MY402QUEUE_OP_PUSH, MY402QUEUE_OP_POP, MY402QUEUE_OP_PEEK,
+    MY402QUEUE_NUM_OPS
+} My402QueueOp;
+
+typedef struct tagMy402QueueStats {
+    long calls[MY402QUEUE_NUM_OPS];
+    int max_members;
+} My402QueueStats;
+#endif /* MY402LIST_STATS */
+
+typedef struct tagMy402Queue {
+    int num_members;
+    int head;           /* slot of the oldest object */
+    int num_slots;      /* 0 or a power of two */
+    void **slots;
+#ifdef MY402LIST_STATS
+    My402QueueStats stats;
+#endif
+} My402Queue;
+
+extern int  My402QueueLength(My402Queue*);
+extern int  My402QueueEmpty(My402Queue*);
+
+extern int  My402QueuePush(My402Queue*, void*);
+extern void *My402QueuePop(My402Queue*);
+extern void *My402QueuePeek(My402Queue*);
+
+extern int  My402QueueInit(My402Queue*);
+extern void My402QueueFree(My402Queue*);
+
+/* Print queue's counters to fp, labelled with name.  A no-op without MY402LIST_STATS. */
+extern void My402QueueStatsPrint(My402Queue*, const char *name, FILE *fp);
+
+/*
+ * MY402QUEUE_TYPED(Name, Type) declares Name, a My402Queue of Type objects,
+ * with static inline Name##Init, Name##Push, Name##Pop, ... wrappers.  Pop,
+ * Peek, Length and Empty are fully inline; Push is inline unless the buffer
+ * has to grow.  The underlying My402Queue is the "queue" member.
+ */
+#ifdef MY402LIST_STATS
+#define MY402QUEUE_TYPED(Name, Type) \
+    typedef struct tag##Name { \
+        My402Queue queue; \
+    } Name; \
+    static inline int Name##Init(Name *q) { return My402QueueInit(&q->queue); } \
+    static inline void Name##Free(Name *q) { My402QueueFree(&q->queue); } \
+    static inline int Name##Length(Name *q) { return My402QueueLength(&q->queue); } \
+    static inline int Name##Empty(Name *q) { return My402QueueEmpty(&q->queue); } \
+    static inline int Name##Push(Name *q, Type *obj) { return My402QueuePush(&q->queue, obj); } \
+    static inline Type *Name##Peek(Name *q) { return (Type*) My402QueuePeek(&q->queue); } \
+    static inline Type *Name##Pop(Name *q) { return (Type*) My402QueuePop(&q->queue); }
+#else
+#define MY402QUEUE_TYPED(Name, Type) \
+    typedef struct tag##Name { \
+        My402Queue queue; \
+    } Name; \
+    static inline int Name##Init(Name *q) { return My402QueueInit(&q->queue); } \
+    static inline void Name##Free(Name *q) { My402QueueFree(&q->queue); } \
+    static inline int Name##Length(Name *q) { return q->queue.num_members; } \
+    static inline int Name##Empty(Name *q) { return q->queue.num_members <= 0; } \
+    static inline int Name##Push(Name *q, Type *obj) { \
+        My402Queue *queue = &q->queue; \
+        if (queue->num_members == queue->num_slots) { \
+            return My402QueuePush(queue, obj); \
+        } \
+        queue->slots[(queue->head + queue->num_members) & (queue->num_slots - 1)] = obj; \
+        queue->num_members++; \
+        return TRUE; \
+    } \
+    static inline Type *Name##Peek(Name *q) { return Name##Empty(q) ? NULL : (Type*) q->queue.slots[q->queue.head]; } \
+    static inline Type *Name##Pop(Name *q) { \
+        My402Queue *queue = &q->queue; \
+        if (queue->num_members <= 0) { \
+            return NULL; \
+        } \
+        Type *obj = (Type*) queue->slots[queue->head]; \
+        queue->head = (queue->head + 1) & (queue->num_slots - 1); \
+        queue->num_members--; \
+        return obj; \
+    }
+#endif /* MY402LIST_STATS */
+
+#endif /*_MY402QUEUE_H_*/
@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "cs402.h"
+#include "my402rculist.h"
+
+// Unlink tries to reclaim once this many elements are waiting.
+#define RECLAIM_BATCH 64
+
+int My402RcuListLength(My402RcuList *list) {
+    return atomic_load_explicit(&list->num_members, memory_order_relaxed);
+}
+
+// The fence pairs with the one in Reclaim: either the writer sees this reader's epoch,
+// or every load this reader makes afterwards sees the unlinks made before the writer's fence.
+void My402RcuListReadLock(My402RcuList *list, My402RcuReader *reader) {
+    unsigned long epoch = atomic_load_explicit(&list->epoch, memory_order_acquire);
+    atomic_store_explicit(&reader->epoch, epoch, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+void My402RcuListReadUnlock(My402RcuList *list, My402RcuReader *reader) {
+    atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+}
+
+My402RcuElem *My402RcuListFirst(My402RcuList *list) {
+    My402RcuElem *elem = atomic_load_explicit(&(list->anchor).next, memory_order_acquire);
+    return elem == &(list->anchor) ? NULL : elem;
+}
+
+My402RcuElem *My402RcuListNext(My402RcuList *list, My402RcuElem *elem) {
+    My402RcuElem *next = atomic_load_explicit(&elem->next, memory_order_acquire);
+    return next == &(list->anchor) ? NULL : next;
+}
+
+void My402RcuListWriteLock(My402RcuList *list) {
+    pthread_mutex_lock(&list->write_lock);
+}
+
+void My402RcuListWriteUnlock(My402RcuList *list) {
+    pthread_mutex_unlock(&list->write_lock);
+}
+
+// Fill in the new element completely, then publish it with one release store.
+static int LinkAfter(My402RcuList *list, void *obj, My402RcuElem *prev) {
+    My402RcuElem *elem = malloc(sizeof(My402RcuElem));
+    if (elem == NULL) {
+        return FALSE;
+    }
+    My402RcuElem *next = atomic_load_explicit(&prev->next, memory_order_relaxed);
+    elem->obj = obj;
+    atomic_init(&elem->next, next);
+    elem->prev = prev;
+    elem->retired_next = NULL;
+    elem->retired_epoch = 0;
+    atomic_store_explicit(&prev->next, elem, memory_order_release);
+    next->prev = elem;
+    atomic_fetch_add_explicit(&list->num_members, 1, memory_order_relaxed);
+    return TRUE;
+}
+
+int My402RcuListAppend(My402RcuList *list, void *obj) {
+    return LinkAfter(list, obj, (list->anchor).prev);
+}
+
+int My402RcuListPrepend(My402RcuList *list, void *obj) {
+    return LinkAfter(list, obj, &(list->anchor));
+}
+
+int My402RcuListInsertAfter(My402RcuList *list, void *obj, My402RcuElem *elem) {
+    return LinkAfter(list, obj, elem == NULL ? (list->anchor).prev : elem);
+}
+
+// elem->next is left alone so that a reader standing on elem still finds its way back.
+void My402RcuListUnlink(My402RcuList *list, My402RcuElem *elem) {
+    My402RcuElem *prev = elem->prev;
+    My402RcuElem *next = atomic_load_explicit(&elem->next, memory_order_relaxed);
+    atomic_store_explicit(&prev->next, next, memory_order_release);
+    next->prev = prev;
+    atomic_fetch_sub_explicit(&list->num_members, 1, memory_order_relaxed);
+    elem->retired_epoch = atomic_fetch_add(&list->epoch, 1);
+    elem->retired_next = NULL;
+    if (list->retired == NULL) {
+        list->retired = elem;
+    } else {
+        list->retired_last->retired_next = elem;
+    }
+    list->retired_last = elem;
+    if (++list->num_retired >= RECLAIM_BATCH) {
+        My402RcuListReclaim(list);
+    }
+}
+
+My402RcuElem *My402RcuListLast(My402RcuList *list) {
+    return (list->anchor).prev == &(list->anchor) ? NULL : (list->anchor).prev;
+}
+
+My402RcuElem *My402RcuListPrev(My402RcuList *list, My402RcuElem *elem) {
+    return elem->prev == &(list->anchor) ? NULL : elem->prev;
+}
+
+static void FreeElem(My402RcuList *list, My402RcuElem *elem) {
+    if (list->reclaim != NULL) {
+        list->reclaim(elem->obj);
+    }
+    free(elem);
+}
+
+// An element retired at epoch e is unreachable for a reader that entered at an epoch
+// after e, so everything retired before the oldest active reader's epoch can go.
+int My402RcuListReclaim(My402RcuList *list) {
+    atomic_thread_fence(memory_order_seq_cst);
+    unsigned long oldest = ULONG_MAX;
+    for (My402RcuReader *reader = list->readers; reader != NULL; reader = reader->next) {
+        unsigned long epoch = atomic_load_explicit(&reader->epoch, memory_order_acquire);
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+    // The retired list is in epoch order, so the freeable elements form its head.
+    while (list->retired != NULL && list->retired->retired_epoch < oldest) {
+        My402RcuElem *elem = list->retired;
+        list->retired = elem->retired_next;
+        FreeElem(list, elem);
+        list->num_retired--;
+    }
+    return list->num_retired;
+}
+
+void My402RcuListRegister(My402RcuList *list, My402RcuReader *reader) {
+    atomic_init(&reader->epoch, 0);
+    pthread_mutex_lock(&list->write_lock);
+    reader->next = list->readers;
+    list->readers = reader;
+    pthread_mutex_unlock(&list->write_lock);
+}
+
+void My402RcuListUnregister(My402RcuList *list, My402RcuReader *reader) {
+    pthread_mutex_lock(&list->write_lock);
+    for (My402RcuReader **link = &list->readers; *link != NULL; link = &(*link)->next) {
+        if (*link == reader) {
+            *link = reader->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&list->write_lock);
+}
+
+int My402RcuListInit(My402RcuList *list, void (*reclaim)(void*)) {
+    if (pthread_mutex_init(&list->write_lock, NULL) != 0) {
+        return FALSE;
+    }
+    atomic_init(&list->num_members, 0);
+    (list->anchor).obj = NULL;
+    atomic_init(&(list->anchor).next, &(list->anchor));
+    (list->anchor).prev = &(list->anchor);
+    atomic_init(&list->epoch, 1);
+    list->readers = NULL;
+    list->retired = NULL;
+    list->retired_last = NULL;
+    list->num_retired = 0;
+    list->reclaim = reclaim;
+    return TRUE;
+}
+
+void My402RcuListFree(My402RcuList *list) {
+    My402RcuListReclaim(list);
+    My402RcuElem *elem = atomic_load_explicit(&(list->anchor).next, memory_order_relaxed);
+    while (elem != &(list->anchor)) {
+        My402RcuElem *next = atomic_load_explicit(&elem->next, memory_order_relaxed);
+        FreeElem(list, elem);
+        elem = next;
+    }
+    atomic_init(&(list->anchor).next, &(list->anchor));
+    (list->anchor).prev = &(list->anchor);
+    atomic_store(&list->num_members, 0);
+    pthread_mutex_destroy(&list->write_lock);
+}
@@ -0,0 +1,86 @@
+#ifndef _MY402RCULIST_H_
+#define _MY402RCULIST_H_
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include "cs402.h"
+
+/*
+ * Read-mostly concurrent sibling of My402List.  Readers walk the list with
+ * First/Next and read Length without taking any lock; writers serialize on
+ * the list's own mutex (My402RcuListWriteLock/WriteUnlock) and must hold it
+ * for every other call.
+ *
+ * Unlinked elements are not freed right away, since a reader may still be
+ * standing on one.  They are retired with the current global epoch and freed
+ * once every reader that was inside a read-side section at that epoch has
+ * left it (epoch-based reclamation).  A retired element keeps its next
+ * pointer, so a reader on it carries on into the live list.  If the list was
+ * initialized with a reclaim function, it is called on the obj of every
+ * element at that point, which is when the obj may safely be freed.
+ *
+ * Every reader thread registers a My402RcuReader once and brackets each
+ * traversal with ReadLock/ReadUnlock.  Readers only move forward and must
+ * not keep an element across ReadUnlock.  A traversal sees each element that
+ * stays on the list throughout it exactly once, in order; elements inserted
+ * or unlinked meanwhile may or may not be seen.  ReadLock sections do not
+ * nest and should be short, since they hold back reclamation.
+ */
+typedef struct tagMy402RcuElem {
+    void *obj;
+    _Atomic(struct tagMy402RcuElem *) next;
+    struct tagMy402RcuElem *prev;           /* only valid under the write lock */
+    struct tagMy402RcuElem *retired_next;   /* retired list, linked through here */
+    unsigned long retired_epoch;
+} My402RcuElem;
+
+typedef struct tagMy402RcuReader {
+    _Alignas(64) atomic_ulong epoch;        /* 0 when outside a read-side section */
+    struct tagMy402RcuReader *next;         /* registered readers, under the write lock */
+} My402RcuReader;
+
+typedef struct tagMy402RcuList {
+    atomic_int num_members;
+    My402RcuElem anchor;
+
+    pthread_mutex_t write_lock;
+    _Alignas(64) atomic_ulong epoch;        /* starts at 1 */
+    My402RcuReader *readers;
+    My402RcuElem *retired;                  /* oldest first, so reclaiming stops early */
+    My402RcuElem *retired_last;
+    int num_retired;
+    void (*reclaim)(void*);
+} My402RcuList;
+
+/* Reader side, no lock needed. */
+extern int  My402RcuListLength(My402RcuList*);
+extern void My402RcuListReadLock(My402RcuList*, My402RcuReader*);
+extern void My402RcuListReadUnlock(My402RcuList*, My402RcuReader*);
+extern My402RcuElem *My402RcuListFirst(My402RcuList*);
+extern My402RcuElem *My402RcuListNext(My402RcuList*, My402RcuElem*);
+
+/* Writer side, call with the write lock held. */
+extern void My402RcuListWriteLock(My402RcuList*);
+extern void My402RcuListWriteUnlock(My402RcuList*);
+extern int  My402RcuListAppend(My402RcuList*, void*);
+extern int  My402RcuListPrepend(My402RcuList*, void*);
+extern int  My402RcuListInsertAfter(My402RcuList*, void*, My402RcuElem*);
+extern void My402RcuListUnlink(My402RcuList*, My402RcuElem*);
+extern My402RcuElem *My402RcuListLast(My402RcuList*);
+extern My402RcuElem *My402RcuListPrev(My402RcuList*, My402RcuElem*);
+
+/*
+ * Free every retired element that no reader can still reach; returns how
+ * many are left waiting.  Unlink calls this itself now and then.
+ */
+extern int  My402RcuListReclaim(My402RcuList*);
+
+/* Reader registration; takes the write lock itself. */
+extern void My402RcuListRegister(My402RcuList*, My402RcuReader*);
+extern void My402RcuListUnregister(My402RcuList*, My402RcuReader*);
+
+extern int  My402RcuListInit(My402RcuList*, void (*reclaim)(void*));
+/* No reader may be registered.  Frees every element, calling reclaim on the live ones too. */
+extern void My402RcuListFree(My402RcuList*);
+
+#endif /*_MY402RCULIST_H_*/
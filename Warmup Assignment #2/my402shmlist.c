@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "cs402.h"
+#include "my402shmlist.h"
+
+#define MAGIC 0x4d59343032534d4cULL     // "MY402SML"
+#define ALIGN 16
+
+// Every block starts with its total size; a free block also links to the next one.
+typedef struct tagMy402ShmBlock {
+    uint64_t size;
+    My402ShmOff next_free;
+} My402ShmBlock;
+
+static uint64_t RoundUp(uint64_t n) {
+    return (n + ALIGN - 1) & ~(uint64_t) (ALIGN - 1);
+}
+
+static int SizeClass(uint64_t size) {
+    return min(size / ALIGN - 1, MY402SHM_SIZE_CLASSES - 1);
+}
+
+My402ShmRegion *My402ShmRegionInit(void *base, size_t size) {
+    My402ShmRegion *region = (My402ShmRegion*) base;
+    if (size < RoundUp(sizeof(My402ShmRegion)) || ((uintptr_t) base & (ALIGN - 1)) != 0) {
+        return NULL;
+    }
+    memset(region, 0, sizeof(My402ShmRegion));
+    pthread_mutexattr_t mutex_attr;
+    pthread_condattr_t cond_attr;
+    pthread_mutexattr_init(&mutex_attr);
+    pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED);
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setpshared(&cond_attr, PTHREAD_PROCESS_SHARED);
+    int ok = pthread_mutex_init(&region->mutex, &mutex_attr) == 0;
+    if (ok && pthread_cond_init(&region->cv, &cond_attr) != 0) {
+        pthread_mutex_destroy(&region->mutex);
+        ok = FALSE;
+    }
+    pthread_mutexattr_destroy(&mutex_attr);
+    pthread_condattr_destroy(&cond_attr);
+    if (!ok) {
+        return NULL;
+    }
+    region->size = size;
+    region->used = RoundUp(sizeof(My402ShmRegion));
+    region->magic = MAGIC;
+    return region;
+}
+
+My402ShmRegion *My402ShmRegionAttach(void *base) {
+    My402ShmRegion *region = (My402ShmRegion*) base;
+    return region->magic == MAGIC ? region : NULL;
+}
+
+// Only once no process uses the region any more.
+void My402ShmRegionDestroy(My402ShmRegion *region) {
+    pthread_cond_destroy(&region->cv);
+    pthread_mutex_destroy(&region->mutex);
+    region->magic = 0;
+}
+
+My402ShmOff My402ShmAlloc(My402ShmRegion *region, size_t size) {
+    uint64_t need = RoundUp(sizeof(My402ShmBlock) + max(size, 1));
+    int class = SizeClass(need);
+    My402ShmOff *link = &region->free_blocks[class];
+    // Exact-size classes hold only blocks of that size; the last one is searched first-fit.
+    while (*link != 0) {
+        My402ShmBlock *block = (My402ShmBlock*) My402ShmPtr(region, *link);
+        if (block->size >= need) {
+            My402ShmOff off = *link;
+            *link = block->next_free;
+            return off + sizeof(My402ShmBlock);
+        }
+        link = &block->next_free;
+    }
+    if (region->size - region->used < need) {
+        return 0;
+    }
+    My402ShmOff off = region->used;
+    My402ShmBlock *block = (My402ShmBlock*) My402ShmPtr(region, off);
+    block->size = need;
+    region->used += need;
+    return off + sizeof(My402ShmBlock);
+}
+
+void My402ShmFree(My402ShmRegion *region, My402ShmOff off) {
+    if (off == 0) {
+        return;
+    }
+    off -= sizeof(My402ShmBlock);
+    My402ShmBlock *block = (My402ShmBlock*) My402ShmPtr(region, off);
+    int class = SizeClass(block->size);
+    block->next_free = region->free_blocks[class];
+    region->free_blocks[class] = off;
+}
+
+void *My402ShmPtr(My402ShmRegion *region, My402ShmOff off) {
+    return off == 0 ? NULL : (char*) region + off;
+}
+
+My402ShmOff My402ShmOffset(My402ShmRegion *region, void *ptr) {
+    return ptr == NULL ? 0 : (char*) ptr - (char*) region;
+}
+
+void My402ShmLock(My402ShmRegion *region) {
+    pthread_mutex_lock(&region->mutex);
+}
+
+void My402ShmUnlock(My402ShmRegion *region) {
+    pthread_mutex_unlock(&region->mutex);
+}
+
+void My402ShmWait(My402ShmRegion *region) {
+    pthread_cond_wait(&region->cv, &region->mutex);
+}
+
+void My402ShmBroadcast(My402ShmRegion *region) {
+    pthread_cond_broadcast(&region->cv);
+}
+
+static My402ShmElem *Elem(My402ShmRegion *region, My402ShmOff off) {
+    return (My402ShmElem*) My402ShmPtr(region, off);
+}
+
+My402ShmList *My402ShmListNew(My402ShmRegion *region) {
+    My402ShmList *list = (My402ShmList*) My402ShmPtr(region, My402ShmAlloc(region, sizeof(My402ShmList)));
+    if (list == NULL) {
+        return NULL;
+    }
+    My402ShmOff anchor = My402ShmOffset(region, &list->anchor);
+    list->num_members = 0;
+    (list->anchor).obj = 0;
+    (list->anchor).next = anchor;
+    (list->anchor).prev = anchor;
+    return list;
+}
+
+int My402ShmListLength(My402ShmRegion *region, My402ShmList *list) {
+    return list->num_members;
+}
+
+int My402ShmListEmpty(My402ShmRegion *region, My402ShmList *list) {
+    return list->num_members <= 0;
+}
+
+// Link a new element for obj in after prev, which may be the anchor.
+static int LinkAfter(My402ShmRegion *region, My402ShmList *list, My402ShmOff obj, My402ShmElem *prev) {
+    My402ShmOff off = My402ShmAlloc(region, sizeof(My402ShmElem));
+    if (off == 0) {
+        return FALSE;
+    }
+    My402ShmElem *elem = Elem(region, off);
+    elem->obj = obj;
+    elem->next = prev->next;
+    elem->prev = My402ShmOffset(region, prev);
+    Elem(region, prev->next)->prev = off;
+    prev->next = off;
+    list->num_members++;
+    return TRUE;
+}
+
+int My402ShmListAppend(My402ShmRegion *region, My402ShmList *list, My402ShmOff obj) {
+    return LinkAfter(region, list, obj, Elem(region, (list->anchor).prev));
+}
+
+int My402ShmListPrepend(My402ShmRegion *region, My402ShmList *list, My402ShmOff obj) {
+    return LinkAfter(region, list, obj, &(list->anchor));
+}
+
+void My402ShmListUnlink(My402ShmRegion *region, My402ShmList *list, My402ShmElem *elem) {
+    if (list->num_members <= 0) {
+        return;
+    }
+    Elem(region, elem->prev)->next = elem->next;
+    Elem(region, elem->next)->prev = elem->prev;
+    My402ShmFree(region, My402ShmOffset(region, elem));
+    list->num_members--;
+}
+
+void My402ShmListUnlinkAll(My402ShmRegion *region, My402ShmList *list) {
+    My402ShmOff anchor = My402ShmOffset(region, &list->anchor);
+    My402ShmOff off = (list->anchor).next;
+    while (off != anchor) {
+        My402ShmOff next = Elem(region, off)->next;
+        My402ShmFree(region, off);
+        off = next;
+    }
+    list->num_members = 0;
+    (list->anchor).next = anchor;
+    (list->anchor).prev = anchor;
+}
+
+int My402ShmListInsertAfter(My402ShmRegion *region, My402ShmList *list, My402ShmOff obj, My402ShmElem *elem) {
+    return LinkAfter(region, list, obj, elem == NULL ? Elem(region, (list->anchor).prev) : elem);
+}
+
+int My402ShmListInsertBefore(My402ShmRegion *region, My402ShmList *list, My402ShmOff obj, My402ShmElem *elem) {
+    return LinkAfter(region, list, obj, Elem(region, elem == NULL ? My402ShmOffset(region, &list->anchor) : elem->prev));
+}
+
+My402ShmElem *My402ShmListFirst(My402ShmRegion *region, My402ShmList *list) {
+    return list->num_members <= 0 ? NULL : Elem(region, (list->anchor).next);
+}
+
+My402ShmElem *My402ShmListLast(My402ShmRegion *region, My402ShmList *list) {
+    return list->num_members <= 0 ? NULL : Elem(region, (list->anchor).prev);
+}
+
+My402ShmElem *My402ShmListNext(My402ShmRegion *region, My402ShmList *list, My402ShmElem *elem) {
+    My402ShmElem *next = Elem(region, elem->next);
+    return next == &(list->anchor) ? NULL : next;
+}
+
+My402ShmElem *My402ShmListPrev(My402ShmRegion *region, My402ShmList *list, My402ShmElem *elem) {
+    My402ShmElem *prev = Elem(region, elem->prev);
+    return prev == &(list->anchor) ? NULL : prev;
+}
+
+My402ShmElem *My402ShmListFind(My402ShmRegion *region, My402ShmList *list, My402ShmOff obj) {
+    for (My402ShmElem *elem = My402ShmListFirst(region, list); elem != NULL; elem = My402ShmListNext(region, list, elem)) {
+        if (elem->obj == obj) {
+            return elem;
+        }
+    }
+    return NULL;
+}
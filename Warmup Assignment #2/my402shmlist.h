@@ -0,0 +1,93 @@
+#ifndef _MY402SHMLIST_H_
+#define _MY402SHMLIST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "cs402.h"
+
+/*
+ * Position-independent My402List for sharing between processes.  Everything
+ * lives inside one caller-provided region (an mmap()ed file or shm_open()
+ * segment) that each process may map at a different address, so links are
+ * byte offsets from the start of the region instead of pointers, with 0
+ * meaning NULL.  My402ShmPtr() and My402ShmOffset() convert between the two
+ * in the calling process.
+ *
+ * The region starts with a header holding a process-shared mutex and
+ * condition variable, a root offset where the creator can leave the lists
+ * for others to find, and a small allocator: 16-byte aligned blocks carved
+ * off the end of the used part, recycled through per-size free lists.  The
+ * region never grows; My402ShmAlloc() returns 0 when it is full.
+ *
+ * As with My402List, list functions do no locking of their own.  Processes
+ * sharing a region serialize on its mutex with My402ShmLock/Unlock, which
+ * also covers the allocator.  Objects on the list are offsets too, normally
+ * of blocks from My402ShmAlloc() in the same region.
+ */
+typedef uint64_t My402ShmOff;
+
+#define MY402SHM_SIZE_CLASSES 32
+
+typedef struct tagMy402ShmRegion {
+    uint64_t magic;
+    uint64_t size;                  /* bytes in the region, header included */
+    uint64_t used;                  /* bytes handed out so far, header included */
+    My402ShmOff root;               /* for the caller */
+    My402ShmOff free_blocks[MY402SHM_SIZE_CLASSES];    /* by size / 16 - 1; the last holds the rest */
+    pthread_mutex_t mutex;
+    pthread_cond_t cv;
+} My402ShmRegion;
+
+typedef struct tagMy402ShmElem {
+    My402ShmOff obj;
+    My402ShmOff next;
+    My402ShmOff prev;
+} My402ShmElem;
+
+typedef struct tagMy402ShmList {
+    int num_members;
+    My402ShmElem anchor;
+} My402ShmList;
+
+/*
+ * Init formats size bytes at base as a new, empty region; Attach checks that
+ * base (mapped by another process, possibly elsewhere) holds one.  Both
+ * return NULL on failure.
+ */
+extern My402ShmRegion *My402ShmRegionInit(void *base, size_t size);
+extern My402ShmRegion *My402ShmRegionAttach(void *base);
+extern void My402ShmRegionDestroy(My402ShmRegion*);
+
+extern My402ShmOff My402ShmAlloc(My402ShmRegion*, size_t size);
+extern void My402ShmFree(My402ShmRegion*, My402ShmOff);
+extern void *My402ShmPtr(My402ShmRegion*, My402ShmOff);
+extern My402ShmOff My402ShmOffset(My402ShmRegion*, void*);
+
+extern void My402ShmLock(My402ShmRegion*);
+extern void My402ShmUnlock(My402ShmRegion*);
+/* Wait on the region's condition variable; call with the lock held. */
+extern void My402ShmWait(My402ShmRegion*);
+extern void My402ShmBroadcast(My402ShmRegion*);
+
+/* A new empty list allocated in the region, or NULL if it is full. */
+extern My402ShmList *My402ShmListNew(My402ShmRegion*);
+
+extern int  My402ShmListLength(My402ShmRegion*, My402ShmList*);
+extern int  My402ShmListEmpty(My402ShmRegion*, My402ShmList*);
+
+extern int  My402ShmListAppend(My402ShmRegion*, My402ShmList*, My402ShmOff obj);
+extern int  My402ShmListPrepend(My402ShmRegion*, My402ShmList*, My402ShmOff obj);
+extern void My402ShmListUnlink(My402ShmRegion*, My402ShmList*, My402ShmElem*);
+extern void My402ShmListUnlinkAll(My402ShmRegion*, My402ShmList*);
+extern int  My402ShmListInsertAfter(My402ShmRegion*, My402ShmList*, My402ShmOff obj, My402ShmElem*);
+extern int  My402ShmListInsertBefore(My402ShmRegion*, My402ShmList*, My402ShmOff obj, My402ShmElem*);
+
+extern My402ShmElem *My402ShmListFirst(My402ShmRegion*, My402ShmList*);
+extern My402ShmElem *My402ShmListLast(My402ShmRegion*, My402ShmList*);
+extern My402ShmElem *My402ShmListNext(My402ShmRegion*, My402ShmList*, My402ShmElem*);
+extern My402ShmElem *My402ShmListPrev(My402ShmRegion*, My402ShmList*, My402ShmElem*);
+
+extern My402ShmElem *My402ShmListFind(My402ShmRegion*, My402ShmList*, My402ShmOff obj);
+
+#endif /*_MY402SHMLIST_H_*/
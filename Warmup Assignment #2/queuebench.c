@@ -0,0 +1,269 @@
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "cs402.h"
+#include "my402list.h"
+#include "my402poollist.h"
+#include "my402lfqueue.h"
+#include "my402queue.h"
+
+// Throughput of the lock-free queues against a mutex-guarded My402List, with
+// several producers handing objects to one consumer. Every run also checks that
+// each object arrives exactly once and in per-producer order.
+//
+// Two single-threaded lines compare a push/peek/pop cycle on My402Queue made
+// through the functions in my402queue.c (queue=ring_call) with the same cycle
+// through MY402QUEUE_TYPED wrappers, which warmup2's PacketQueue uses and which
+// inline everything but buffer growth (queue=ring_typed).
+
+typedef enum { MUTEX_LIST, MPSC, SPSC } QueueKind;
+
+// A pooled My402List behind one mutex and condition variable, the way warmup2 shares its queues.
+typedef struct {
+    My402PoolList list;
+    My402ListPool pool;
+    pthread_mutex_t mutex;
+    pthread_cond_t fill;
+    int closed;
+} LockedList;
+
+typedef struct {
+    QueueKind kind;
+    My402MpscQueue mpsc;
+    My402SpscQueue spsc;
+    LockedList locked;
+    atomic_int stop;    // set by the consumer on a failed check, so producers give up
+} Bench;
+
+typedef struct {
+    Bench *bench;
+    long id;
+} Producer;
+
+MY402QUEUE_TYPED(ObjQueue, void)
+
+int num_producers = 3;
+long num_items = 1000000;
+int num_slots = 1024;
+
+void usage(void) {
+    fprintf(stderr, "usage: queuebench [-p producers] [-n items_per_producer] [-s slots]\n");
+    exit(1);
+}
+
+double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Objects are never dereferenced; the pointer value encodes (producer, sequence number).
+void *encode(long id, long seq) {
+    return (void*) (uintptr_t) ((id << 40) | (seq + 1));
+}
+
+void push(Bench *bench, void *obj) {
+    switch (bench->kind) {
+        case MUTEX_LIST:
+            pthread_mutex_lock(&bench->locked.mutex);
+            My402PoolListAppend(&bench->locked.list, obj);
+            pthread_cond_signal(&bench->locked.fill);
+            pthread_mutex_unlock(&bench->locked.mutex);
+            break;
+        case MPSC:
+            while (!My402MpscQueuePush(&bench->mpsc, obj) && !atomic_load(&bench->stop)) {
+                sched_yield();
+            }
+            break;
+        case SPSC:
+            while (!My402SpscQueuePush(&bench->spsc, obj) && !atomic_load(&bench->stop)) {
+                sched_yield();
+            }
+            break;
+    }
+}
+
+void *pop_wait(Bench *bench) {
+    void *obj = NULL;
+    switch (bench->kind) {
+        case MUTEX_LIST:
+            pthread_mutex_lock(&bench->locked.mutex);
+            while (My402ListEmpty(&bench->locked.list.list) && !bench->locked.closed) {
+                pthread_cond_wait(&bench->locked.fill, &bench->locked.mutex);
+            }
+            if (!My402ListEmpty(&bench->locked.list.list)) {
+                My402ListElem *elem = My402ListFirst(&bench->locked.list.list);
+                obj = elem->obj;
+                My402PoolListUnlink(&bench->locked.list, elem);
+            }
+            pthread_mutex_unlock(&bench->locked.mutex);
+            break;
+        case MPSC:
+            obj = My402MpscQueuePopWait(&bench->mpsc);
+            break;
+        case SPSC:
+            obj = My402SpscQueuePopWait(&bench->spsc);
+            break;
+    }
+    return obj;
+}
+
+void close_queue(Bench *bench) {
+    switch (bench->kind) {
+        case MUTEX_LIST:
+            pthread_mutex_lock(&bench->locked.mutex);
+            bench->locked.closed = 1;
+            pthread_cond_broadcast(&bench->locked.fill);
+            pthread_mutex_unlock(&bench->locked.mutex);
+            break;
+        case MPSC:
+            My402MpscQueueClose(&bench->mpsc);
+            break;
+        case SPSC:
+            My402SpscQueueClose(&bench->spsc);
+            break;
+    }
+}
+
+void *produce(void *arg) {
+    Producer *producer = (Producer*) arg;
+    for (long seq = 0; seq < num_items && !atomic_load(&producer->bench->stop); seq++) {
+        push(producer->bench, encode(producer->id, seq));
+    }
+    return NULL;
+}
+
+const char *kind_name(QueueKind kind) {
+    return kind == MUTEX_LIST ? "mutex_list" : kind == MPSC ? "mpsc" : "spsc";
+}
+
+int run(QueueKind kind, int producers) {
+    Bench bench;
+    bench.kind = kind;
+    atomic_init(&bench.stop, 0);
+    if (kind == MUTEX_LIST) {
+        My402ListPoolInit(&bench.locked.pool, 1024);
+        My402PoolListInit(&bench.locked.list, &bench.locked.pool);
+        pthread_mutex_init(&bench.locked.mutex, NULL);
+        pthread_cond_init(&bench.locked.fill, NULL);
+        bench.locked.closed = 0;
+    } else if (kind == MPSC) {
+        if (!My402MpscQueueInit(&bench.mpsc, num_slots)) {
+            fprintf(stderr, "Error: Number of slots must be a power of two\n");
+            exit(1);
+        }
+    } else if (!My402SpscQueueInit(&bench.spsc, num_slots)) {
+        fprintf(stderr, "Error: Number of slots must be a power of two\n");
+        exit(1);
+    }
+    Producer *args = malloc(producers * sizeof(Producer));
+    pthread_t *threads = malloc(producers * sizeof(pthread_t));
+    long *next_seq = calloc(producers, sizeof(long));
+    double start = now_ns();
+    for (int i = 0; i < producers; i++) {
+        args[i].bench = &bench;
+        args[i].id = i;
+        pthread_create(&threads[i], NULL, produce, &args[i]);
+    }
+    long received = 0;
+    int ok = 1;
+    long total = num_items * producers;
+    while (received < total) {
+        uintptr_t value = (uintptr_t) pop_wait(&bench);
+        long id = value >> 40;
+        long seq = (value & ((1L << 40) - 1)) - 1;
+        if (value == 0 || id >= producers || seq != next_seq[id]) {
+            // Nobody drains the queue from here on, so a producer waiting for room
+            // must be told to stop before it can be joined.
+            ok = 0;
+            atomic_store(&bench.stop, 1);
+            break;
+        }
+        next_seq[id]++;
+        received++;
+    }
+    for (int i = 0; i < producers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    close_queue(&bench);
+    // Nothing may be left over once every producer's items have been seen.
+    if (ok && pop_wait(&bench) != NULL) {
+        ok = 0;
+    }
+    double elapsed = now_ns() - start;
+    fprintf(stdout, "queue=%s producers=%d items=%ld ns_per_op=%.1f mops=%.2f check=%s\n", kind_name(kind), producers, total, elapsed / total, total * 1000.0 / elapsed, ok ? "ok" : "FAILED");
+    if (kind == MUTEX_LIST) {
+        My402PoolListUnlinkAll(&bench.locked.list);
+        My402ListPoolFree(&bench.locked.pool);
+    } else if (kind == MPSC) {
+        My402MpscQueueFree(&bench.mpsc);
+    } else {
+        My402SpscQueueFree(&bench.spsc);
+    }
+    free(args);
+    free(threads);
+    free(next_seq);
+    return ok;
+}
+
+int run_ring(int typed) {
+    My402Queue queue;
+    ObjQueue typed_queue;
+    My402QueueInit(&queue);
+    ObjQueueInit(&typed_queue);
+    int ok = 1;
+    double start = now_ns();
+    for (long seq = 0; seq < num_items && ok; seq++) {
+        void *obj = encode(0, seq);
+        if (typed) {
+            ObjQueuePush(&typed_queue, obj);
+            ok = ObjQueuePeek(&typed_queue) == obj && ObjQueuePop(&typed_queue) == obj;
+        } else {
+            My402QueuePush(&queue, obj);
+            ok = My402QueuePeek(&queue) == obj && My402QueuePop(&queue) == obj;
+        }
+    }
+    double elapsed = now_ns() - start;
+    ok = ok && My402QueueEmpty(&queue) && ObjQueueEmpty(&typed_queue);
+    fprintf(stdout, "queue=%s producers=1 items=%ld ns_per_op=%.1f mops=%.2f check=%s\n", typed ? "ring_typed" : "ring_call", num_items, elapsed / num_items, num_items * 1000.0 / elapsed, ok ? "ok" : "FAILED");
+    My402QueueFree(&queue);
+    ObjQueueFree(&typed_queue);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    int c;
+    while ((c = getopt(argc, argv, "p:n:s:")) != -1) {
+        switch (c) {
+            case 'p':
+                num_producers = atoi(optarg);
+                break;
+            case 'n':
+                num_items = atol(optarg);
+                break;
+            case 's':
+                num_slots = atoi(optarg);
+                break;
+            default:
+                usage();
+        }
+    }
+    if (num_producers < 1 || num_items < 1 || optind != argc) {
+        usage();
+    }
+    int ok = 1;
+    ok &= run(MUTEX_LIST, 1);
+    ok &= run(SPSC, 1);
+    ok &= run(MPSC, 1);
+    ok &= run(MUTEX_LIST, num_producers);
+    ok &= run(MPSC, num_producers);
+    ok &= run_ring(FALSE);
+    ok &= run_ring(TRUE);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,197 @@
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include "cs402.h"
+#include "my402rculist.h"
+
+// Stress test for My402RcuList. Writers keep replacing the oldest element with a new
+// one while readers walk the whole list over and over and check every object they
+// see is still live. Each run reports reader throughput, so running it with more
+// and more readers shows how lock-free traversal scales against readers that take
+// the writers' mutex, e.g.
+//
+//   list=rcu readers=2 writers=1 size=1000 reads_per_sec=2.1e+08 writes_per_sec=3.2e+06 check=ok
+//
+// The check fails if a reader sees a reclaimed object, if the list loses or gains
+// elements, or if some object is never reclaimed.
+
+#define LIVE 0x4c495645L
+#define DEAD 0x44454144L
+
+typedef struct {
+    atomic_long magic;
+    long seq;
+} Item;
+
+typedef struct {
+    My402RcuList list;
+    int locked_readers;         // readers take the write lock instead of ReadLock
+    atomic_int stop;
+    atomic_long num_live;       // items allocated and not yet reclaimed
+    atomic_long num_bad;
+    atomic_long next_seq;
+} Bench;
+
+typedef struct {
+    Bench *bench;
+    pthread_t thread;
+    long ops;
+} Worker;
+
+int max_readers = 4;
+int num_writers = 1;
+int list_size = 1000;
+int duration_ms = 500;
+
+Bench *reclaim_bench;           // the reclaim callback has no context argument
+
+void usage(void) {
+    fprintf(stderr, "usage: rcubench [-r max_readers] [-w writers] [-n size] [-d duration_ms]\n");
+    exit(1);
+}
+
+double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+Item *new_item(Bench *bench) {
+    Item *item = malloc(sizeof(Item));
+    atomic_init(&item->magic, LIVE);
+    item->seq = atomic_fetch_add(&bench->next_seq, 1);
+    atomic_fetch_add(&bench->num_live, 1);
+    return item;
+}
+
+// Poison before freeing, so a reader that gets here too early most likely sees DEAD.
+void reclaim_item(void *obj) {
+    Item *item = (Item*) obj;
+    atomic_store(&item->magic, DEAD);
+    atomic_fetch_sub(&reclaim_bench->num_live, 1);
+    free(item);
+}
+
+void *write_loop(void *arg) {
+    Worker *worker = (Worker*) arg;
+    Bench *bench = worker->bench;
+    while (!atomic_load_explicit(&bench->stop, memory_order_relaxed)) {
+        My402RcuListWriteLock(&bench->list);
+        My402RcuListUnlink(&bench->list, My402RcuListFirst(&bench->list));
+        My402RcuListAppend(&bench->list, new_item(bench));
+        My402RcuListWriteUnlock(&bench->list);
+        worker->ops++;
+    }
+    return NULL;
+}
+
+void *read_loop(void *arg) {
+    Worker *worker = (Worker*) arg;
+    Bench *bench = worker->bench;
+    My402RcuReader reader;
+    My402RcuListRegister(&bench->list, &reader);
+    while (!atomic_load_explicit(&bench->stop, memory_order_relaxed)) {
+        long seen = 0;
+        long last_seq = -1;
+        if (bench->locked_readers) {
+            My402RcuListWriteLock(&bench->list);
+        } else {
+            My402RcuListReadLock(&bench->list, &reader);
+        }
+        for (My402RcuElem *elem = My402RcuListFirst(&bench->list); elem != NULL; elem = My402RcuListNext(&bench->list, elem)) {
+            Item *item = (Item*) elem->obj;
+            // Items are appended in seq order, so a traversal must see increasing seqs.
+            if (atomic_load_explicit(&item->magic, memory_order_relaxed) != LIVE || item->seq <= last_seq) {
+                atomic_fetch_add(&bench->num_bad, 1);
+            }
+            last_seq = item->seq;
+            seen++;
+        }
+        if (bench->locked_readers) {
+            My402RcuListWriteUnlock(&bench->list);
+        } else {
+            My402RcuListReadUnlock(&bench->list, &reader);
+        }
+        worker->ops += seen;
+    }
+    My402RcuListUnregister(&bench->list, &reader);
+    return NULL;
+}
+
+int run(int locked_readers, int num_readers) {
+    Bench bench;
+    reclaim_bench = &bench;
+    bench.locked_readers = locked_readers;
+    atomic_init(&bench.stop, 0);
+    atomic_init(&bench.num_live, 0);
+    atomic_init(&bench.num_bad, 0);
+    atomic_init(&bench.next_seq, 0);
+    if (!My402RcuListInit(&bench.list, reclaim_item)) {
+        fprintf(stderr, "Error: Failed to initialize My402RcuList\n");
+        exit(1);
+    }
+    for (int i = 0; i < list_size; i++) {
+        My402RcuListAppend(&bench.list, new_item(&bench));
+    }
+    Worker *workers = calloc(num_readers + num_writers, sizeof(Worker));
+    double start = now_ns();
+    for (int i = 0; i < num_readers + num_writers; i++) {
+        workers[i].bench = &bench;
+        pthread_create(&workers[i].thread, NULL, i < num_readers ? read_loop : write_loop, &workers[i]);
+    }
+    struct timespec ts = { duration_ms / 1000, (duration_ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+    atomic_store(&bench.stop, 1);
+    long reads = 0;
+    long writes = 0;
+    for (int i = 0; i < num_readers + num_writers; i++) {
+        pthread_join(workers[i].thread, NULL);
+        if (i < num_readers) {
+            reads += workers[i].ops;
+        } else {
+            writes += workers[i].ops;
+        }
+    }
+    double elapsed = (now_ns() - start) / 1e9;
+    int ok = atomic_load(&bench.num_bad) == 0 && My402RcuListLength(&bench.list) == list_size;
+    My402RcuListFree(&bench.list);
+    ok = ok && atomic_load(&bench.num_live) == 0;
+    fprintf(stdout, "list=%s readers=%d writers=%d size=%d reads_per_sec=%.3g writes_per_sec=%.3g check=%s\n", locked_readers ? "mutex" : "rcu", num_readers, num_writers, list_size, reads / elapsed, writes / elapsed, ok ? "ok" : "FAILED");
+    fflush(stdout);
+    free(workers);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    int c;
+    while ((c = getopt(argc, argv, "r:w:n:d:")) != -1) {
+        switch (c) {
+            case 'r':
+                max_readers = atoi(optarg);
+                break;
+            case 'w':
+                num_writers = atoi(optarg);
+                break;
+            case 'n':
+                list_size = atoi(optarg);
+                break;
+            case 'd':
+                duration_ms = atoi(optarg);
+                break;
+            default:
+                usage();
+        }
+    }
+    if (max_readers < 1 || num_writers < 1 || list_size < 1 || duration_ms < 1 || optind != argc) {
+        usage();
+    }
+    int ok = 1;
+    for (int readers = 1; readers <= max_readers; readers *= 2) {
+        ok &= run(TRUE, readers);
+        ok &= run(FALSE, readers);
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,242 @@
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "cs402.h"
+#include "my402shmlist.h"
+
+// Two-process producer/consumer over a My402ShmList in a shm_open() segment, against
+// the same traffic written through a pipe. The producer is a forked child that maps
+// the segment again on its own (so at a different address than the consumer), and
+// each packet is written once into the region and read in place by the consumer.
+// Every run checks that packets arrive once each, in order and intact, e.g.
+//
+//   transport=shm items=1000000 payload=64 ns_per_item=125.3 check=ok
+
+typedef struct {
+    long seq;
+    int length;
+    unsigned char data[];
+} Packet;
+
+// What the creator leaves at the region's root for the other process.
+typedef struct {
+    My402ShmOff queue;
+    int closed;
+} Root;
+
+long num_items = 1000000;
+int payload = 64;
+int max_depth = 1024;
+
+void usage(void) {
+    fprintf(stderr, "usage: shmbench [-n items] [-s payload_bytes] [-q max_depth]\n");
+    exit(1);
+}
+
+double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+void fill(Packet *packet, long seq) {
+    packet->seq = seq;
+    packet->length = payload;
+    for (int i = 0; i < payload; i++) {
+        packet->data[i] = (unsigned char) (seq + i);
+    }
+}
+
+int check(Packet *packet, long seq) {
+    if (packet->seq != seq || packet->length != payload) {
+        return FALSE;
+    }
+    for (int i = 0; i < payload; i++) {
+        if (packet->data[i] != (unsigned char) (seq + i)) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+void *map(const char *name, size_t size) {
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0) {
+        perror("shm_open");
+        exit(1);
+    }
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror("mmap");
+        exit(1);
+    }
+    return base;
+}
+
+void shm_produce(const char *name, size_t size) {
+    void *base = map(name, size);
+    My402ShmRegion *region = My402ShmRegionAttach(base);
+    if (region == NULL) {
+        fprintf(stderr, "Error: Not a My402Shm region\n");
+        exit(1);
+    }
+    Root *root = (Root*) My402ShmPtr(region, region->root);
+    My402ShmList *queue = (My402ShmList*) My402ShmPtr(region, root->queue);
+    for (long seq = 0; seq < num_items; seq++) {
+        My402ShmLock(region);
+        while (My402ShmListLength(region, queue) >= max_depth) {
+            My402ShmWait(region);
+        }
+        My402ShmOff off = My402ShmAlloc(region, sizeof(Packet) + payload);
+        if (off == 0 || !My402ShmListAppend(region, queue, off)) {
+            fprintf(stderr, "Error: Region is full\n");
+            root->closed = TRUE;
+            My402ShmBroadcast(region);
+            My402ShmUnlock(region);
+            exit(1);
+        }
+        fill((Packet*) My402ShmPtr(region, off), seq);
+        if (My402ShmListLength(region, queue) == 1) {
+            My402ShmBroadcast(region);
+        }
+        My402ShmUnlock(region);
+    }
+    My402ShmLock(region);
+    root->closed = TRUE;
+    My402ShmBroadcast(region);
+    My402ShmUnlock(region);
+    munmap(base, size);
+}
+
+int run_shm(void) {
+    char name[64];
+    snprintf(name, sizeof(name), "/shmbench.%d", (int) getpid());
+    size_t size = 65536 + (size_t) max_depth * (sizeof(My402ShmElem) + sizeof(Packet) + payload + 64);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 || ftruncate(fd, size) != 0) {
+        perror("shm_open");
+        exit(1);
+    }
+    close(fd);
+    void *base = map(name, size);
+    My402ShmRegion *region = My402ShmRegionInit(base, size);
+    My402ShmList *queue = region == NULL ? NULL : My402ShmListNew(region);
+    Root *root = region == NULL ? NULL : (Root*) My402ShmPtr(region, My402ShmAlloc(region, sizeof(Root)));
+    if (queue == NULL || root == NULL) {
+        fprintf(stderr, "Error: Failed to set up the region\n");
+        exit(1);
+    }
+    root->queue = My402ShmOffset(region, queue);
+    root->closed = FALSE;
+    region->root = My402ShmOffset(region, root);
+
+    double start = now_ns();
+    pid_t pid = fork();
+    if (pid == 0) {
+        shm_produce(name, size);
+        _exit(0);
+    }
+    int ok = TRUE;
+    long received = 0;
+    My402ShmLock(region);
+    while (1) {
+        while (My402ShmListEmpty(region, queue) && !root->closed) {
+            My402ShmWait(region);
+        }
+        if (My402ShmListEmpty(region, queue)) {
+            break;
+        }
+        My402ShmElem *elem = My402ShmListFirst(region, queue);
+        Packet *packet = (Packet*) My402ShmPtr(region, elem->obj);
+        ok = ok && check(packet, received);
+        received++;
+        My402ShmFree(region, elem->obj);
+        My402ShmListUnlink(region, queue, elem);
+        if (My402ShmListLength(region, queue) == max_depth - 1) {
+            My402ShmBroadcast(region);
+        }
+    }
+    My402ShmUnlock(region);
+    int status;
+    waitpid(pid, &status, 0);
+    double elapsed = now_ns() - start;
+    ok = ok && received == num_items && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    fprintf(stdout, "transport=shm items=%ld payload=%d ns_per_item=%.1f check=%s\n", num_items, payload, elapsed / num_items, ok ? "ok" : "FAILED");
+    My402ShmRegionDestroy(region);
+    munmap(base, size);
+    shm_unlink(name);
+    return ok;
+}
+
+// Baseline: the same packets serialized through a pipe.
+int run_pipe(void) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        exit(1);
+    }
+    size_t packet_size = sizeof(Packet) + payload;
+    Packet *packet = malloc(packet_size);
+    double start = now_ns();
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        FILE *out = fdopen(fds[1], "w");
+        for (long seq = 0; seq < num_items; seq++) {
+            fill(packet, seq);
+            fwrite(packet, packet_size, 1, out);
+        }
+        fclose(out);
+        _exit(0);
+    }
+    close(fds[1]);
+    FILE *in = fdopen(fds[0], "r");
+    int ok = TRUE;
+    long received = 0;
+    while (fread(packet, packet_size, 1, in) == 1) {
+        ok = ok && check(packet, received);
+        received++;
+    }
+    fclose(in);
+    int status;
+    waitpid(pid, &status, 0);
+    double elapsed = now_ns() - start;
+    ok = ok && received == num_items && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    fprintf(stdout, "transport=pipe items=%ld payload=%d ns_per_item=%.1f check=%s\n", num_items, payload, elapsed / num_items, ok ? "ok" : "FAILED");
+    free(packet);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    int c;
+    while ((c = getopt(argc, argv, "n:s:q:")) != -1) {
+        switch (c) {
+            case 'n':
+                num_items = atol(optarg);
+                break;
+            case 's':
+                payload = atoi(optarg);
+                break;
+            case 'q':
+                max_depth = atoi(optarg);
+                break;
+            default:
+                usage();
+        }
+    }
+    if (num_items < 1 || payload < 0 || max_depth < 1 || optind != argc) {
+        usage();
+    }
+    fflush(stdout);
+    int ok = run_shm();
+    fflush(stdout);
+    ok &= run_pipe();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -9,7 +9,7 @@
 #include <math.h>
 #include <ctype.h>
 #include "cs402.h"
-#include "my402list.h"
+#include "my402queue.h"
 
 typedef struct {
     long interval; // In microseconds.
@@ -25,6 +25,8 @@ typedef struct {
     int num;
 } Packet;
 
+MY402QUEUE_TYPED(PacketQueue, Packet)
+
 // Default value.
 double lambda = 1, mu = 0.35, r = 1.5;
 int B = 10, P = 3, num = 20;
@@ -38,8 +40,8 @@ int dropped_packets = 0;
 int remaining_packets = 0; // Shared.
 int transmitted_packets = 0; // Shared.
 
-My402List queue1; // Shared.
-My402List queue2; // Shared.
+PacketQueue queue1; // Shared.
+PacketQueue queue2; // Shared.
 
 char *trace_file = NULL;
 FILE *fp = NULL;
@@ -78,12 +80,16 @@ void usage(void) {
     exit(1);
 }
 
+// A packet that cannot be queued would vanish from the statistics, so stop instead.
+void out_of_memory(void) {
+    fprintf(stderr, "Error: Out of memory\n");
+    exit(1);
+}
+
 // Critical section.
 void move_packet(void) {
-    My402ListElem *elem = My402ListFirst(&queue1);
-    Packet *packet = (Packet*) (elem->obj);
+    Packet *packet = PacketQueuePop(&queue1);
     current_tokens -= packet->tokens_required;
-    My402ListUnlink(&queue1, elem);
     struct timeval packet_leave_queue1_time;
     gettimeofday(&packet_leave_queue1_time, NULL);
     packet->packet_leave_queue1_time = packet_leave_queue1_time;
@@ -94,7 +100,9 @@ void move_packet(void) {
     } else {
 	fprintf(stdout, "p%d leaves Q1, time in Q1 = %0.3lfms, token bucket now has %d tokens\n", packet->num, time_in_queue1, current_tokens);
     }
-    My402ListAppend(&queue2, packet);
+    if (!PacketQueuePush(&queue2, packet)) {
+        out_of_memory();
+    }
     struct timeval packet_enter_queue2_time;
     gettimeofday(&packet_enter_queue2_time, NULL);
     packet->packet_enter_queue2_time = packet_enter_queue2_time;
@@ -122,8 +130,8 @@ void *generate_token(void *arg) {
         }
         // Check if generate_token_thread can be terminated. Check at the start of the function
         // in case all packets have arrived and queue1 is empty.
-        if (remaining_packets == 0 && My402ListEmpty(&queue1)) {
-            if (My402ListEmpty(&queue2)) {
+        if (remaining_packets == 0 && PacketQueueEmpty(&queue1)) {
+            if (PacketQueueEmpty(&queue2)) {
                 // The server threads need to be terminated if queue2 is empty as well.
                 pthread_cond_broadcast(&fill);
             }
@@ -145,8 +153,8 @@ void *generate_token(void *arg) {
 	    dropped_tokens++;
 	    fprintf(stdout, "token t%d arrives, dropped\n", total_tokens);
 	}
-	if (!My402ListEmpty(&queue1)) {
-	    if (((Packet*) (My402ListFirst(&queue1)->obj))->tokens_required <= current_tokens) {
+	if (!PacketQueueEmpty(&queue1)) {
+	    if (PacketQueuePeek(&queue1)->tokens_required <= current_tokens) {
                 move_packet();
                 pthread_cond_broadcast(&fill);
 	    }
@@ -241,6 +249,9 @@ void *generate_packet(void *arg) {
     struct timeval previous_packet_arrival_time = start_emulation;
     while (1) {
         Packet *packet = malloc(sizeof(Packet));
+        if (packet == NULL) {
+            out_of_memory();
+        }
         get_parameter(packet);
         usleep(packet->interval);
         pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
@@ -265,8 +276,10 @@ void *generate_packet(void *arg) {
 	    fprintf(stdout, ", dropped\n");
 	} else {
 	    fprintf(stdout, "\n");
-	    int empty = My402ListEmpty(&queue1);
-	    My402ListAppend(&queue1, packet);
+	    int empty = PacketQueueEmpty(&queue1);
+	    if (!PacketQueuePush(&queue1, packet)) {
+	        out_of_memory();
+	    }
 	    struct timeval packet_enter_queue1_time;
 	    gettimeofday(&packet_enter_queue1_time, NULL);
 	    packet->packet_enter_queue1_time = packet_enter_queue1_time;
@@ -293,7 +306,7 @@ void *serve_packet(void *arg) {
     char *server = (char*) arg;
     while (1) {
         pthread_mutex_lock(&mutex);
-        if ((remaining_packets == 0 && My402ListEmpty(&queue1) && My402ListEmpty(&queue2)) || (signal_received)) {
+        if ((remaining_packets == 0 && PacketQueueEmpty(&queue1) && PacketQueueEmpty(&queue2)) || (signal_received)) {
             // If another thread is waiting/sleeping, it has to be woken up and terminates itself.
             // This is necessary if pthread_cond_signal is used instead of pthread_cond_broadcast
             // in generate_packet and generate_token.
@@ -301,17 +314,15 @@ void *serve_packet(void *arg) {
             pthread_mutex_unlock(&mutex);
             pthread_exit(NULL);
         }
-        while (My402ListEmpty(&queue2)) {
+        while (PacketQueueEmpty(&queue2)) {
             pthread_cond_wait(&fill, &mutex);
             // Check if this server thread can be terminated after being woken up.
-            if ((remaining_packets == 0 && My402ListEmpty(&queue1) && My402ListEmpty(&queue2)) || (signal_received)) {
+            if ((remaining_packets == 0 && PacketQueueEmpty(&queue1) && PacketQueueEmpty(&queue2)) || (signal_received)) {
             	pthread_mutex_unlock(&mutex);
             	pthread_exit(NULL);
             }
         }
-        My402ListElem *elem = My402ListFirst(&queue2);
-        Packet *packet = (Packet*) (elem -> obj);
-        My402ListUnlink(&queue2, elem);
+        Packet *packet = PacketQueuePop(&queue2);
         struct timeval packet_leave_queue2_time;
         gettimeofday(&packet_leave_queue2_time, NULL);
         packet->packet_leave_queue2_time = packet_leave_queue2_time;
@@ -371,20 +382,16 @@ void *sigint_catch(void *arg) {
 // This is called after all other threads are terminated.
 // If ctrl-c is not pressed, both queue1 and queue2 should be empty already.
 void remove_packets() {
-    while (!My402ListEmpty(&queue1)) {
-        My402ListElem *elem = My402ListFirst(&queue1);
-        Packet *packet = (Packet*) (elem->obj);
-        My402ListUnlink(&queue1, elem);
+    while (!PacketQueueEmpty(&queue1)) {
+        Packet *packet = PacketQueuePop(&queue1);
         struct timeval packet_remove_time;
         gettimeofday(&packet_remove_time, NULL);
         fprintf(stdout, "%012.3lfms: ", time_elapsed(packet_remove_time, start_emulation));
         fprintf(stdout, "p%d removed from Q1\n", packet->num);
         free(packet);
     }
-    while (!My402ListEmpty(&queue2)) {
-        My402ListElem *elem = My402ListFirst(&queue2);
-        Packet *packet = (Packet*) (elem->obj);
-        My402ListUnlink(&queue2, elem);
+    while (!PacketQueueEmpty(&queue2)) {
+        Packet *packet = PacketQueuePop(&queue2);
         struct timeval packet_remove_time;
         gettimeofday(&packet_remove_time, NULL);
         fprintf(stdout, "%012.3lfms: ", time_elapsed(packet_remove_time, start_emulation));
@@ -446,8 +453,8 @@ void print_statistics() {
 }
 
 int main(int argc, char *argv[]) {
-    My402ListInit(&queue1);
-    My402ListInit(&queue2);
+    PacketQueueInit(&queue1);
+    PacketQueueInit(&queue2);
     for (int i = 1; i < argc; i += 2) {
         char *c = argv[i];
         if (c[0] != '-') {
@@ -571,6 +578,10 @@ int main(int argc, char *argv[]) {
     pthread_join(serve_packet_s2_thread, NULL);
 
     remove_packets();
+    My402QueueStatsPrint(&queue1.queue, "Q1", stderr);
+    My402QueueStatsPrint(&queue2.queue, "Q2", stderr);
+    PacketQueueFree(&queue1);
+    PacketQueueFree(&queue2);
     gettimeofday(&end_emulation, NULL);
     fprintf(stdout, "%012.3fms: emulation ends\n", time_elapsed(end_emulation, start_emulation));
     fprintf(stdout, "\n");